@@ -0,0 +1,117 @@
+/*
+ * Compares raku_json_hash(), reached through raku_json_key_make(), with the
+ * byte-at-a-time FNV-1a that hashed keys before it. Both hash the same
+ * payload field names, once with their length known and once after
+ * strnlen, and the best of RUNS rounds is reported.
+ */
+
+#include <RAKU/json.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define RUNS 7
+#define ROUNDS 1000000L
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+static const char *const keys[] = {
+    "id", "type", "name", "guild_id", "channel_id", "content", "timestamp",
+    "edited_timestamp", "author", "username", "discriminator", "global_name",
+    "avatar", "public_flags", "mention_everyone", "referenced_message",
+    "premium_progress_bar_enabled", "default_thread_rate_limit_per_user",
+    "t", "s", "op", "d"
+};
+
+#define KEY_COUNT (sizeof(keys) / sizeof(keys[0]))
+
+static unsigned int lengths[KEY_COUNT];
+
+static uint32_t fnv1a(const char *chars, unsigned int count)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        hash ^= (uint32_t)chars[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t wyhash(const char *chars, unsigned int count)
+{
+    return raku_json_key_make(chars, count).hash;
+}
+
+static double now(void)
+{
+    struct timespec time;
+    timespec_get(&time, TIME_UTC);
+    return ((double)time.tv_sec * 1e9) + (double)time.tv_nsec;
+}
+
+/*
+ * Returns the best time per hash, in nanoseconds. The hash is called
+ * through a volatile pointer so that neither side is inlined into the loop
+ * while the other pays for a call into the library.
+ */
+static double run(uint32_t (*hash)(const char*, unsigned int), bool measure, volatile uint32_t *sink)
+{
+    uint32_t (*volatile call)(const char*, unsigned int) = hash;
+
+    double best = 0;
+    for (int r = 0; r < RUNS; ++r)
+    {
+        uint32_t sum = 0;
+        double start = now();
+        for (long i = 0; i < ROUNDS; ++i)
+        {
+            for (size_t k = 0; k < KEY_COUNT; ++k)
+            {
+                unsigned int count =
+                    measure ?
+                        (unsigned int)strnlen(keys[k], UINT_MAX) :
+                        lengths[k];
+                sum += call(keys[k], count);
+            }
+        }
+        double elapsed = now() - start;
+
+        *sink += sum;
+        if (r == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    return best / ((double)ROUNDS * KEY_COUNT);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < KEY_COUNT; ++i)
+        lengths[i] = (unsigned int)strlen(keys[i]);
+
+    volatile uint32_t sink = 0;
+    printf("%zu keys, best of %d runs of %ld hashes\n", KEY_COUNT, RUNS, ROUNDS * (long)KEY_COUNT);
+    printf("  FNV-1a               %6.2f ns/key\n", run(fnv1a, false, &sink));
+    printf("  wyhash               %6.2f ns/key\n", run(wyhash, false, &sink));
+    printf("  FNV-1a with strnlen  %6.2f ns/key\n", run(fnv1a, true, &sink));
+    printf("  wyhash with strnlen  %6.2f ns/key\n", run(wyhash, true, &sink));
+
+    /* Numeric keys are the worst case for the low bits a table indexes with. */
+    static unsigned int buckets[4096];
+    unsigned int most = 0;
+    for (unsigned int i = 0; i < 200000; ++i)
+    {
+        char key[16];
+        int count = snprintf(key, sizeof(key), "%u", i * 7919);
+        unsigned int *bucket = &buckets[wyhash(key, (unsigned int)count) & 4095];
+        if (++*bucket > most)
+            most = *bucket;
+    }
+    printf("200000 numeric keys in 4096 buckets: max %u, mean %.1f\n", most, 200000 / 4096.0);
+
+    return 0;
+}
\ No newline at end of file
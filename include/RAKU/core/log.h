@@ -2,6 +2,8 @@
 #define RAKU_CORE_LOG_H
 
 #include <RAKU/export.h>
+#include <RAKU/core/defs.h>
+#include <RAKU/core/status.h>
 
 #define LOG_INFO(...)  raku_log(RAKU_LOG_LEVEL_INFO,  __VA_ARGS__)
 #define LOG_TRACE(...) raku_log(RAKU_LOG_LEVEL_TRACE, __VA_ARGS__)
@@ -22,9 +24,56 @@ enum log_level
     RAKU_LOG_LEVEL_FATAL
 };
 
+/*
+ * Where the background writer sends log lines. write gets one formatted,
+ * newline-terminated line at a time; flush, called whenever the writer runs
+ * out of lines, and close may be NULL. Every callback gets ctx back, and all
+ * of them run on the writer thread only.
+ */
+struct raku_log_sink
+{
+    void (*write)(void *ctx, enum log_level level, const char *line, size_t size);
+    void (*flush)(void *ctx);
+    void (*close)(void *ctx);
+    void *ctx;
+};
+
+/*
+ * Lines are formatted on the calling thread and written to stdout, or,
+ * once raku_log_start() ran, queued for the writer thread without ever
+ * blocking: lines that find the queue full are dropped and counted. Lines
+ * longer than 511 bytes are cut.
+ */
 RAKU_API
 void raku_log(enum log_level level, const char *format, ...);
 
+/*
+ * Starts the writer thread on a copy of sink, or on stdout when sink is
+ * NULL. Returns RAKU_OUT_OF_RANGE when the writer is already running.
+ */
+RAKU_API
+enum raku_status raku_log_start(const struct raku_log_sink *sink);
+
+/*
+ * Writes out the queued lines, stops the writer thread and closes its sink.
+ * Lines logged while it stops may be lost.
+ */
+RAKU_API
+void raku_log_stop(void);
+
+/* A sink writing to the file descriptor fd, which it never closes. */
+RAKU_API
+void raku_log_sink_fd(int fd, struct raku_log_sink *out);
+
+/*
+ * A sink appending to the file at path. Once the file would grow past
+ * max_size bytes it is rotated: path.1 up to path.max_files keep the older
+ * lines, or the file is truncated when max_files is 0. A max_size of 0
+ * never rotates.
+ */
+RAKU_API
+enum raku_status raku_log_sink_file(const char *path, size_t max_size, unsigned int max_files, struct raku_log_sink *out);
+
 #if defined(__cplusplus)
 }
 #endif
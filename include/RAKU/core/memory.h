@@ -9,18 +9,151 @@
 extern "C" {
 #endif
 
+/*
+ * Where raku_alloc() and friends take memory from. realloc and free are
+ * given the size the block was allocated with, and every callback gets ctx
+ * back. alloc and realloc return NULL when out of memory.
+ */
+struct raku_allocator
+{
+    void* (*alloc)(void *ctx, size_t size);
+    void* (*realloc)(void *ctx, void *block, size_t old_size, size_t new_size);
+    void (*free)(void *ctx, void *block, size_t size);
+    void *ctx;
+};
+
+/* What an allocation is for, as broken down by raku_memory_stats(). */
+enum raku_memory_category
+{
+    RAKU_MEMORY_OTHER,
+    RAKU_MEMORY_NODES,
+    RAKU_MEMORY_STRINGS,
+    RAKU_MEMORY_OBJECT_TABLES,
+    RAKU_MEMORY_ARRAYS,
+    RAKU_MEMORY_POOL_SLABS,
+    RAKU_MEMORY_ARENAS,
+
+    RAKU_MEMORY_CATEGORIES
+};
+
+struct raku_memory_stats
+{
+    size_t live;
+    size_t peak;
+    size_t allocations;
+    size_t reallocations;
+};
+
+struct raku_arena_chunk;
+
+struct raku_arena
+{
+    struct raku_arena_chunk *first;
+    struct raku_arena_chunk *current;
+    size_t chunk_size;
+    const struct raku_allocator *allocator;
+};
+
+/*
+ * Installs allocator for the whole process, or restores malloc() when it is
+ * NULL. Only call it while nothing allocated by RAKU is alive.
+ */
+RAKU_API
+void raku_allocator_set(const struct raku_allocator *allocator);
+
+/*
+ * Overrides the process allocator on the calling thread, until called again
+ * with NULL. allocator must outlive the override, and the threads whose
+ * pools took slabs from it. Memory must be freed under the allocator it was
+ * allocated from. Returns the previous override.
+ */
+RAKU_API
+const struct raku_allocator* raku_allocator_set_local(const struct raku_allocator *allocator);
+
+/* Returns the allocator raku_alloc() uses on the calling thread. */
+RAKU_API
+const struct raku_allocator* raku_allocator_get(void);
+
+/* Same as the _for() variants, counting the memory as RAKU_MEMORY_OTHER. */
 RAKU_API
 enum raku_status raku_alloc(size_t size, void **out);
 
 RAKU_API
-enum raku_status raku_realloc(void *block, size_t new_size, void **out);
+enum raku_status raku_realloc(void *block, size_t old_size, size_t new_size, void **out);
+
+RAKU_API
+void raku_free(void *block, size_t size);
+
+RAKU_API
+enum raku_status raku_alloc_for(enum raku_memory_category category, size_t size, void **out);
+
+RAKU_API
+enum raku_status raku_realloc_for(enum raku_memory_category category, void *block, size_t old_size, size_t new_size, void **out);
 
 RAKU_API
-void raku_free(void *block);
+void raku_free_for(enum raku_memory_category category, void *block, size_t size);
+
+/*
+ * Fills out[RAKU_MEMORY_CATEGORIES] with the process-wide counters of each
+ * category. Counting is compiled in with RAKU_MEMORY_STATS only: otherwise
+ * every counter reads 0.
+ */
+RAKU_API
+void raku_memory_stats(struct raku_memory_stats *out);
 
 RAKU_API
 void raku_zero_memory(void *block, size_t size);
 
+/* Size classes of the node pools: 8, 16, 32 and 64 bytes. */
+#define RAKU_POOL_CLASSES 4
+
+struct raku_pool_stats
+{
+    size_t block_size;
+    size_t slabs;
+    size_t blocks;
+    size_t free;
+};
+
+/*
+ * Allocates a small fixed-size block from the calling thread's pool for its
+ * size class and the current allocator, or from raku_alloc() when size is
+ * above 64 bytes. Slabs go back to their allocator once all their blocks are
+ * freed, except the one a pool keeps for reuse until its thread exits. Slabs
+ * are counted as RAKU_MEMORY_POOL_SLABS whether their blocks are in use or
+ * not, and blocks above 64 bytes as RAKU_MEMORY_NODES.
+ */
+RAKU_API
+enum raku_status raku_pool_alloc(size_t size, void **out);
+
+/*
+ * Returns block, allocated with raku_pool_alloc(size), to the pool it came
+ * from. A block freed on another thread is handed back to its pool's thread.
+ */
+RAKU_API
+void raku_pool_free(void *block, size_t size);
+
+/*
+ * Fills out[RAKU_POOL_CLASSES] with the occupancy of the calling thread's
+ * pools for the current allocator. Blocks freed by other threads count as
+ * in use until the pool takes them back.
+ */
+RAKU_API
+void raku_pool_get_stats(struct raku_pool_stats *out);
+
+/* Chunks come from the allocator raku_alloc() uses when the arena is initialized. */
+RAKU_API
+void raku_arena_init(struct raku_arena *arena, size_t chunk_size);
+
+RAKU_API
+enum raku_status raku_arena_alloc(struct raku_arena *arena, size_t size, void **out);
+
+RAKU_API
+void raku_arena_reset(struct raku_arena *arena);
+
+RAKU_API
+void raku_arena_free(struct raku_arena *arena);
+
 #if defined(__cplusplus)
 }
 #endif
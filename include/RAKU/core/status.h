@@ -22,7 +22,9 @@ enum raku_status
     RAKU_JSON_INVALID_NUMBER,
     RAKU_JSON_MISSING_PRECISION,
     RAKU_JSON_MISSING_EXPONENT,
-    RAKU_JSON_EXPECTED_END
+    RAKU_JSON_EXPECTED_END,
+    RAKU_JSON_INVALID_SNOWFLAKE,
+    RAKU_JSON_INCOMPLETE
 };
 
 RAKU_API
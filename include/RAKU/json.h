@@ -3,6 +3,7 @@
 
 #include <RAKU/export.h>
 #include <RAKU/string.h>
+#include <RAKU/snowflake.h>
 #include <RAKU/core/defs.h>
 #include <RAKU/core/status.h>
 
@@ -20,6 +21,13 @@ enum json_value_type
     RAKU_JSON_OBJECT
 };
 
+enum json_parse_option
+{
+    RAKU_JSON_PARSE_DEFAULT      = 0,
+    RAKU_JSON_PARSE_VIEWS        = 1 << 0,
+    RAKU_JSON_PARSE_TYPED_ARRAYS = 1 << 1
+};
+
 enum json_format_option
 {
     RAKU_JSON_FORMAT_COMPACT = 0,
@@ -35,27 +43,271 @@ struct json_string;
 struct json_array;
 struct json_object;
 
+struct json_atom;
+struct json_stream;
+
+struct raku_arena;
+
 struct json_error
 {
     unsigned int column;
     unsigned int row;
 };
 
+/*
+ * A key hashed once by raku_json_key_make() for any number of lookups.
+ * chars is not copied and must outlive the key.
+ */
+struct json_key
+{
+    const char *chars;
+    unsigned int count;
+    uint32_t hash;
+};
+
+/* A member for raku_json_object_create_from(). */
+struct json_pair
+{
+    const char *key;
+    struct json_value *value;
+};
+
+/*
+ * Walks the members of an object in insertion order, see
+ * raku_json_object_iter_begin(). key, size and value describe the member
+ * the last successful raku_json_object_iter_next() moved to.
+ */
+struct json_object_iter
+{
+    struct json_object *object;
+    unsigned int index;
+
+    const char *key;
+    unsigned int size;
+    struct json_value *value;
+};
+
+/* A position on a value inside a source string, see raku_json_lazy_open(). */
+struct json_cursor
+{
+    const char *value;
+};
+
+struct json_handler
+{
+    enum raku_status (*on_null)(void *context);
+    enum raku_status (*on_bool)(void *context, bool value);
+    enum raku_status (*on_number)(void *context, struct json_number *value);
+    enum raku_status (*on_string)(void *context, const struct raku_string *value);
+    enum raku_status (*on_array_start)(void *context);
+    enum raku_status (*on_array_end)(void *context);
+    enum raku_status (*on_object_start)(void *context);
+    enum raku_status (*on_key)(void *context, const struct raku_string *key);
+    enum raku_status (*on_object_end)(void *context);
+};
+
 RAKU_API
 enum raku_status raku_json_parse(const char *src, struct json_value **out);
 
 RAKU_API
 enum raku_status raku_json_parse_err(const char *src, struct json_value **out, struct json_error *err);
 
+/*
+ * Parses src with every node and buffer of the resulting tree bump-allocated
+ * from arena. The tree is read-only, raku_json_value_free() is a no-op on it
+ * and it is released as a whole by raku_arena_reset() or raku_arena_free().
+ */
+RAKU_API
+enum raku_status raku_json_parse_arena(const char *src, struct raku_arena *arena, struct json_value **out);
+
+RAKU_API
+enum raku_status raku_json_parse_arena_err(
+    const char *src,
+    struct raku_arena *arena,
+    struct json_value **out,
+    struct json_error *err);
+
+/*
+ * Parses src according to options, allocating from arena when it is not NULL.
+ *
+ * With RAKU_JSON_PARSE_VIEWS, strings without escape sequences reference
+ * their bytes in src instead of owning a copy. src must outlive the tree,
+ * and the raku_string returned by raku_json_string_get() for such strings is
+ * not NUL-terminated. Setting a new value on a view gives it its own copy.
+ *
+ * With RAKU_JSON_PARSE_TYPED_ARRAYS and no arena, arrays holding only bools,
+ * only integers, or only reals store their elements unboxed, see raku_json_array_as_doubles(). Getting a number node
+ * out of such an array, or pushing a node in, converts it back to an array
+ * of nodes, while raku_json_array_get_number() and friends read it as is.
+ */
+RAKU_API
+enum raku_status raku_json_parse_opt(
+    const char *src,
+    enum json_parse_option options,
+    struct raku_arena *arena,
+    struct json_value **out,
+    struct json_error *err);
+
+/*
+ * Parses src without building a tree, calling handler in document order.
+ * Any callback may be NULL. Strings and keys are not NUL-terminated and are
+ * only valid for the duration of the call, as is number. A callback
+ * returning anything but RAKU_OK stops the parse with that status.
+ */
+RAKU_API
+enum raku_status raku_json_parse_events(
+    const char *src,
+    const struct json_handler *handler,
+    void *context,
+    struct json_error *err);
+
+/*
+ * Creates a resumable parser for documents that arrive in chunks, allocating
+ * the tree from arena when it is not NULL.
+ */
+RAKU_API
+enum raku_status raku_json_stream_create(struct raku_arena *arena, struct json_stream **out);
+
+RAKU_API
+void raku_json_stream_free(struct json_stream *stream);
+
+/* Drops any partial document and error, ready for a new document. */
+RAKU_API
+void raku_json_stream_reset(struct json_stream *stream);
+
+/*
+ * Parses the size bytes at chunk as the continuation of the current
+ * document. Returns RAKU_JSON_INCOMPLETE until the document closes, then
+ * RAKU_OK with the tree in *out and the stream ready for the next document.
+ * Anything but whitespace after the closing byte in the same chunk is
+ * RAKU_JSON_EXPECTED_END. Errors are sticky until raku_json_stream_reset().
+ */
+RAKU_API
+enum raku_status raku_json_stream_feed(
+    struct json_stream *stream,
+    const char *chunk,
+    size_t size,
+    struct json_value **out);
+
+/*
+ * Signals the end of input. Completes a top-level number, which cannot be
+ * told apart from a truncated one until then, and reports
+ * RAKU_JSON_INCOMPLETE if the document is still open.
+ */
+RAKU_API
+enum raku_status raku_json_stream_finish(struct json_stream *stream, struct json_value **out);
+
+/* Returns the position of the last error reported by the stream. */
+RAKU_API
+struct json_error raku_json_stream_error(struct json_stream *stream);
+
+/*
+ * Positions out on the root value of src without parsing it. Cursors point
+ * into src, which must outlive them. Values are decoded only when read, and
+ * values stepped over on the way are skipped by matching quotes and brackets
+ * without being validated.
+ */
+RAKU_API
+enum raku_status raku_json_lazy_open(const char *src, struct json_cursor *out);
+
+RAKU_API
+enum json_value_type raku_json_lazy_get_type(const struct json_cursor *cursor);
+
+/*
+ * Positions out on the value of key in object. Returns RAKU_OUT_OF_RANGE if
+ * object is not an object or has no such key.
+ */
+RAKU_API
+enum raku_status raku_json_lazy_find_field(const struct json_cursor *object, const char *key, struct json_cursor *out);
+
+/*
+ * Positions out on the first element of array, then raku_json_lazy_next()
+ * moves element to its next sibling. Both return RAKU_OUT_OF_RANGE past the
+ * last element.
+ */
+RAKU_API
+enum raku_status raku_json_lazy_first(const struct json_cursor *array, struct json_cursor *out);
+
+RAKU_API
+enum raku_status raku_json_lazy_next(struct json_cursor *element);
+
+RAKU_API
+enum raku_status raku_json_lazy_at(const struct json_cursor *array, unsigned int index, struct json_cursor *out);
+
+/*
+ * The getters decode the value with the same routines as the parser.
+ * They return RAKU_OUT_OF_RANGE if the value is of another type.
+ */
+RAKU_API
+enum raku_status raku_json_lazy_get_bool(const struct json_cursor *cursor, bool *out);
+
+RAKU_API
+enum raku_status raku_json_lazy_get_number(const struct json_cursor *cursor, double *out);
+
+RAKU_API
+enum raku_status raku_json_lazy_get_int64(const struct json_cursor *cursor, int64_t *out);
+
+RAKU_API
+enum raku_status raku_json_lazy_get_uint64(const struct json_cursor *cursor, uint64_t *out);
+
+/* Replaces the contents of out with the string, reusing its storage. */
+RAKU_API
+enum raku_status raku_json_lazy_get_string(const struct json_cursor *cursor, struct raku_string *out);
+
+RAKU_API
+bool raku_json_lazy_equalc(const struct json_cursor *cursor, const char *value);
+
+RAKU_API
+enum raku_status raku_json_lazy_get_snowflake(const struct json_cursor *cursor, raku_snowflake *out);
+
+/* Parses the value at cursor into a tree, allocating from arena when it is not NULL. */
+RAKU_API
+enum raku_status raku_json_lazy_parse(const struct json_cursor *cursor, struct raku_arena *arena, struct json_value **out);
+
+/*
+ * Serializes value into out, reusing its storage. The exact size of the
+ * output is computed first so that it is written without reallocating.
+ */
 RAKU_API
 enum raku_status raku_json_value_to_string(struct json_value *value, enum json_format_option options, struct raku_string *out);
 
+/* Returns the number of chars value serializes to, without NUL terminator. */
+RAKU_API
+size_t raku_json_value_measure(struct json_value *value, enum json_format_option options);
+
+/*
+ * Serializes value into the size bytes at buffer, without NUL terminator.
+ * *written receives the size of the output. Returns RAKU_OUT_OF_RANGE and
+ * leaves buffer untouched if it is smaller than that.
+ */
+RAKU_API
+enum raku_status raku_json_value_to_buffer(
+    struct json_value *value,
+    enum json_format_option options,
+    char *buffer,
+    size_t size,
+    size_t *written);
+
 RAKU_API
 enum json_value_type raku_json_value_get_type(struct json_value *value);
 
 RAKU_API
 bool raku_json_value_of_type(struct json_value *value, enum json_value_type type);
 
+/*
+ * Shared, immutable null, true and false nodes. The parser uses them for
+ * every literal, though NULL is still taken as null everywhere, and
+ * raku_json_value_free() leaves them alone.
+ */
+RAKU_API
+struct json_value* raku_json_null(void);
+
+RAKU_API
+struct json_bool* raku_json_true(void);
+
+RAKU_API
+struct json_bool* raku_json_false(void);
+
 RAKU_API
 enum raku_status raku_json_bool_create(struct json_bool **out);
 
@@ -86,6 +338,29 @@ void raku_json_number_set(struct json_number *number, double value);
 RAKU_API
 double raku_json_number_get(struct json_number *number);
 
+RAKU_API
+void raku_json_number_set_int64(struct json_number *number, int64_t value);
+
+RAKU_API
+void raku_json_number_set_uint64(struct json_number *number, uint64_t value);
+
+/*
+ * Returns true if number holds an integer that was stored exactly, either
+ * parsed from an integer literal or set with one of the integer setters.
+ */
+RAKU_API
+bool raku_json_number_is_integer(struct json_number *number);
+
+/*
+ * Reads number as a 64-bit integer. Returns RAKU_OUT_OF_RANGE if the stored
+ * value is not an integer or does not fit in the requested type.
+ */
+RAKU_API
+enum raku_status raku_json_number_get_int64(struct json_number *number, int64_t *out);
+
+RAKU_API
+enum raku_status raku_json_number_get_uint64(struct json_number *number, uint64_t *out);
+
 RAKU_API
 void raku_json_string_set(struct json_string *string, struct raku_string *value);
 
@@ -101,9 +376,17 @@ bool raku_json_string_equal(const struct json_string *string, const struct json_
 RAKU_API
 bool raku_json_string_equalc(const struct json_string *string, const char *other);
 
+/*
+ * Reads string as a decimal snowflake. The digits are converted on every
+ * call, which never writes to the node and is safe on shared documents.
+ */
+RAKU_API
+enum raku_status raku_json_string_as_snowflake(const struct json_string *string, raku_snowflake *out);
+
 RAKU_API
 enum raku_status raku_json_array_push(struct json_array *array, struct json_value *value);
 
+/* Adds the shared node of raku_json_true() or raku_json_false(), so nothing is allocated. */
 RAKU_API
 enum raku_status raku_json_array_push_bool(struct json_array *array, bool value);
 
@@ -134,18 +417,92 @@ void raku_json_array_remove_stringc(struct json_array *array, const char *value)
 RAKU_API
 enum raku_status raku_json_array_remove_at(struct json_array *array, unsigned int index);
 
+/*
+ * Contiguous views of typed arrays. Returns RAKU_OUT_OF_RANGE if array is
+ * not of that type, and a NULL span for empty arrays. The span is valid
+ * until array is modified or one of its nodes is accessed.
+ */
+RAKU_API
+enum raku_status raku_json_array_as_doubles(struct json_array *array, const double **out);
+
+RAKU_API
+enum raku_status raku_json_array_as_int64s(struct json_array *array, const int64_t **out);
+
+RAKU_API
+enum raku_status raku_json_array_as_bools(struct json_array *array, const bool **out);
+
+/* Removes the value at index by moving the last value into its place. */
+RAKU_API
+enum raku_status raku_json_array_swap_remove(struct json_array *array, unsigned int index);
+
+/*
+ * Removes and frees every value predicate returns true for, keeping the
+ * others in order, in a single pass. Returns the count of removed values.
+ */
+RAKU_API
+unsigned int raku_json_array_remove_if(
+    struct json_array *array,
+    bool (*predicate)(struct json_value *value, void *context),
+    void *context);
+
+/* Frees the values past the first count ones. */
+RAKU_API
+void raku_json_array_truncate(struct json_array *array, unsigned int count);
+
+/*
+ * Typed arrays of numbers are converted back to arrays of nodes first,
+ * since the nodes handed out may be set, which can fail with
+ * RAKU_NO_MEMORY. Typed arrays of bools hand out the shared nodes of
+ * raku_json_true() and raku_json_false() instead.
+ */
 RAKU_API
 enum raku_status raku_json_array_get(struct json_array *array, unsigned int index, struct json_value **out);
 
+/*
+ * Read the element at index of any array without converting typed ones.
+ * Return RAKU_OUT_OF_RANGE past the end, when the element is of another
+ * type or, for raku_json_array_get_int64(), not an integer that fits.
+ */
+RAKU_API
+enum raku_status raku_json_array_get_bool(const struct json_array *array, unsigned int index, bool *out);
+
+RAKU_API
+enum raku_status raku_json_array_get_number(const struct json_array *array, unsigned int index, double *out);
+
+RAKU_API
+enum raku_status raku_json_array_get_int64(const struct json_array *array, unsigned int index, int64_t *out);
+
+/* Converts typed arrays back to arrays of nodes first, returning NULL if that fails. */
 RAKU_API
 struct json_value* const* raku_json_array_values(struct json_array *array);
 
 RAKU_API
 unsigned int raku_json_array_size(struct json_array *array);
 
+/* Makes room for capacity values in total, so the pushes that follow don't reallocate. */
+RAKU_API
+enum raku_status raku_json_array_reserve(struct json_array *array, unsigned int capacity);
+
+/* Appends the count values at values, growing the array at most once. */
+RAKU_API
+enum raku_status raku_json_array_push_many(struct json_array *array, struct json_value *const *values, unsigned int count);
+
+/* Makes room for capacity members in total, so the sets that follow don't rebuild the table. */
+RAKU_API
+enum raku_status raku_json_object_reserve(struct json_object *object, unsigned int capacity);
+
+/*
+ * Creates an object holding the count pairs, allocated and indexed once.
+ * Like raku_json_object_set(), a repeated key replaces and frees the value
+ * before it. On failure the values still belong to the caller.
+ */
+RAKU_API
+enum raku_status raku_json_object_create_from(const struct json_pair *pairs, unsigned int count, struct json_object **out);
+
 RAKU_API
 enum raku_status raku_json_object_set(struct json_object *object, const char *key, struct json_value *value);
 
+/* Adds the shared node of raku_json_true() or raku_json_false(), so nothing is allocated. */
 RAKU_API
 enum raku_status raku_json_object_set_bool(struct json_object *object, const char *key, bool value);
 
@@ -167,6 +524,100 @@ bool raku_json_object_has(struct json_object *object, const char *key);
 RAKU_API
 enum raku_status raku_json_object_get(struct json_object *object, const char *key, struct json_value **out);
 
+/*
+ * The accessors above for a key of size chars, which needs no NUL
+ * terminator and may be empty.
+ */
+RAKU_API
+enum raku_status raku_json_object_set_n(struct json_object *object, const char *key, size_t size, struct json_value *value);
+
+RAKU_API
+void raku_json_object_remove_n(struct json_object *object, const char *key, size_t size);
+
+RAKU_API
+bool raku_json_object_has_n(struct json_object *object, const char *key, size_t size);
+
+RAKU_API
+enum raku_status raku_json_object_get_n(struct json_object *object, const char *key, size_t size, struct json_value **out);
+
+RAKU_API
+struct json_key raku_json_key_make(const char *key, size_t size);
+
+RAKU_API
+bool raku_json_object_has_key(struct json_object *object, const struct json_key *key);
+
+RAKU_API
+enum raku_status raku_json_object_get_key(struct json_object *object, const struct json_key *key, struct json_value **out);
+
+/*
+ * Seeds the hash of keys and strings so that untrusted payloads cannot be
+ * crafted to collide in one bucket. Must be called before any JSON value,
+ * key or atom is created, since hashes made under another seed no longer
+ * match.
+ */
+RAKU_API
+void raku_json_hash_seed(uint64_t seed);
+
+/*
+ * Atoms are interned object keys, shared by every document and hashed
+ * once. Only the keys registered here are interned: parsing and setting
+ * keys share an atom already in the table but never add one, so payloads
+ * cannot fill it. The lookups below take an atom to skip hashing the key
+ * again. Interning returns RAKU_OUT_OF_RANGE for empty keys, keys longer
+ * than 48 chars, or once the table holds 2048 atoms. Atoms are valid until
+ * raku_json_atom_free_all().
+ */
+RAKU_API
+enum raku_status raku_json_atom_intern(const char *key, const struct json_atom **out);
+
+/* Interns count keys, e.g. the field names of an API, ahead of the first parse. */
+RAKU_API
+enum raku_status raku_json_atom_seed(const char *const *keys, unsigned int count);
+
+/*
+ * Frees every interned atom and empties the table. Every document holding
+ * one of them must be freed first, and no other thread may use atoms while
+ * it runs.
+ */
+RAKU_API
+void raku_json_atom_free_all(void);
+
+RAKU_API
+const char* raku_json_atom_get(const struct json_atom *atom);
+
+RAKU_API
+bool raku_json_object_has_atom(struct json_object *object, const struct json_atom *key);
+
+RAKU_API
+enum raku_status raku_json_object_get_atom(struct json_object *object, const struct json_atom *key, struct json_value **out);
+
+/*
+ * Reads the value of key as a snowflake, either a decimal string or a
+ * non-negative integer number. Returns RAKU_OUT_OF_RANGE if key is missing.
+ */
+RAKU_API
+enum raku_status raku_json_object_get_snowflake(struct json_object *object, const char *key, raku_snowflake *out);
+
+RAKU_API
+unsigned int raku_json_object_size(struct json_object *object);
+
+/*
+ * Starts iter before the first member of object. Each call to
+ * raku_json_object_iter_next() then moves it to the next member in the
+ * order the members were first set, returning false past the last one.
+ * Setting a new key or removing one invalidates the iterator.
+ *
+ *     struct json_object_iter iter;
+ *     raku_json_object_iter_begin(object, &iter);
+ *     while (raku_json_object_iter_next(&iter))
+ *         ... iter.key, iter.value ...
+ */
+RAKU_API
+void raku_json_object_iter_begin(struct json_object *object, struct json_object_iter *iter);
+
+RAKU_API
+bool raku_json_object_iter_next(struct json_object_iter *iter);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -2,6 +2,7 @@
 #define RAKU_RAKU_H
 
 #include <RAKU/json.h>
+#include <RAKU/snowflake.h>
 #include <RAKU/string.h>
 #include <RAKU/core/defs.h>
 #include <RAKU/core/log.h>
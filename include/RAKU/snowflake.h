@@ -0,0 +1,42 @@
+#ifndef RAKU_SNOWFLAKE_H
+#define RAKU_SNOWFLAKE_H
+
+#include <RAKU/export.h>
+#include <RAKU/core/defs.h>
+#include <RAKU/core/status.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Milliseconds between the Unix epoch and the first second of 2015. */
+#define RAKU_SNOWFLAKE_EPOCH 1420070400000ULL
+
+typedef uint64_t raku_snowflake;
+
+/*
+ * Parses count decimal digits at chars into out. Returns
+ * RAKU_JSON_INVALID_SNOWFLAKE if chars holds anything but 1 to 20 digits or
+ * the value does not fit in 64 bits.
+ */
+RAKU_API
+enum raku_status raku_snowflake_parse(const char *chars, unsigned int count, raku_snowflake *out);
+
+/* Returns the creation time of snowflake in milliseconds since the Unix epoch. */
+RAKU_API
+uint64_t raku_snowflake_timestamp(raku_snowflake snowflake);
+
+RAKU_API
+uint8_t raku_snowflake_worker(raku_snowflake snowflake);
+
+RAKU_API
+uint8_t raku_snowflake_process(raku_snowflake snowflake);
+
+RAKU_API
+uint16_t raku_snowflake_sequence(raku_snowflake snowflake);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
\ No newline at end of file
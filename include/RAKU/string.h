@@ -4,22 +4,47 @@
 #include <RAKU/core/defs.h>
 #include <RAKU/core/status.h>
 
+/* Strings shorter than this are kept in the struct itself. */
+#define RAKU_STRING_INLINE_SIZE 16
+
+/*
+ * Short strings are stored over the heap pointer and capacity, so moving the
+ * struct around keeps them valid. A struct copy of a longer string only
+ * borrows its chars: hand a string over with raku_string_own(). Read the
+ * chars through raku_string_chars(). It is NULL only for a string that has
+ * never held storage; an empty inline string still has its buffer.
+ */
 struct raku_string
 {
-    char *chars;
+    union
+    {
+        struct
+        {
+            char *chars;
+            unsigned int capacity;
+        } heap;
+        char chars[RAKU_STRING_INLINE_SIZE];
+    } data;
     unsigned int count;
-    unsigned int capacity;
+    bool is_inline;
 };
 
+static inline char *raku_string_chars(const struct raku_string *string)
+{
+    return string->is_inline ? (char*)string->data.chars : string->data.heap.chars;
+}
+
 RAKU_API
 void raku_string_init(struct raku_string *string);
 
 RAKU_API
 void raku_string_free(struct raku_string *string);
 
+/* Moves other into string, leaving other empty. */
 RAKU_API
 void raku_string_own(struct raku_string *string, struct raku_string *other);
 
+/* Takes over other, which must come from raku_alloc() with room for its NUL terminator only. */
 RAKU_API
 void raku_string_ownc(struct raku_string *string, char *other);
 
@@ -38,6 +63,28 @@ enum raku_status raku_string_writes(struct raku_string *string, const struct rak
 RAKU_API
 enum raku_status raku_string_writesc(struct raku_string *string, const char *other);
 
+/* Makes room for capacity chars in total, so the writes that follow don't reallocate. */
+RAKU_API
+enum raku_status raku_string_reserve(struct raku_string *string, unsigned int capacity);
+
+RAKU_API
+enum raku_status raku_string_append_n(struct raku_string *string, const char *chars, unsigned int count);
+
+/* Appends printf-style output, formatted in place into the spare capacity. */
+RAKU_API
+enum raku_status raku_string_append_fmt(struct raku_string *string, const char *format, ...);
+
+/*
+ * Makes room for size more chars and returns where they start in out. Write
+ * up to size chars there, then raku_string_commit() how many were written:
+ * the string is only NUL-terminated again at that point.
+ */
+RAKU_API
+enum raku_status raku_string_span(struct raku_string *string, unsigned int size, char **out);
+
+RAKU_API
+void raku_string_commit(struct raku_string *string, unsigned int count);
+
 RAKU_API
 bool raku_string_equal(const struct raku_string *string, const struct raku_string *other);
 
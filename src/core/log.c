@@ -1,8 +1,31 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <RAKU/core/log.h>
+#include <RAKU/core/memory.h>
+#include <RAKU/debug.h>
 
 #include <time.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <io.h>
+#else
+    #include <errno.h>
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL _Thread_local
+#endif
 
 #define TIME_BUFFER_SIZE 25
 #define TIME_FORMAT "%a %d %b %Y %H:%M:%S"
@@ -13,6 +36,10 @@
     #define LOG_FORMAT "[%s] %-5s | "
 #endif
 
+#define LOG_LINE_SIZE 512
+#define LOG_RING_SIZE 4096
+#define LOG_PATH_SIZE 1024
+
 static const char *log_levels[] = {
     "INFO",
     "TRACE",
@@ -21,23 +48,511 @@ static const char *log_levels[] = {
     "FATAL"
 };
 
-static void get_time(char *buffer, int max_size, const char *format)
+/*
+ * Bounded MPSC queue: a slot is free for the producer that claims position
+ * when its sequence equals position, and holds a line for the writer when
+ * it equals position + 1. Slots are static, so a producer racing
+ * raku_log_stop() never writes into freed memory.
+ */
+struct log_slot
+{
+    volatile size_t sequence;
+    size_t size;
+    enum log_level level;
+    char line[LOG_LINE_SIZE];
+};
+
+static struct log_slot log_slots[LOG_RING_SIZE];
+static volatile size_t log_head;
+static size_t log_tail;
+static volatile size_t log_ready;
+
+static volatile size_t log_running;
+static volatile size_t log_dropped;
+
+/* The sink in use, a struct raku_log_sink* published by raku_log_start(). */
+static volatile size_t log_sink;
+static struct raku_log_sink log_sink_storage;
+
+/*
+ * The writer sleeps on log_wake once the ring is empty, after raising
+ * log_waiting. The producer that finds it raised wakes it up, so only the
+ * first line after an idle period takes the lock.
+ */
+static volatile size_t log_waiting;
+
+#if defined(_WIN32)
+    static HANDLE log_writer;
+    static SRWLOCK log_lock = SRWLOCK_INIT;
+    static CONDITION_VARIABLE log_wake = CONDITION_VARIABLE_INIT;
+#else
+    static pthread_t log_writer;
+    static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t log_wake = PTHREAD_COND_INITIALIZER;
+#endif
+
+/* Each thread formats into its own line, and renders the time once a second. */
+static THREAD_LOCAL char line_buffer[LOG_LINE_SIZE];
+static THREAD_LOCAL time_t cached_second = -1;
+static THREAD_LOCAL char cached_time[TIME_BUFFER_SIZE];
+
+static inline size_t load_acquire(volatile size_t *value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (size_t)_InterlockedCompareExchangePointer((void* volatile*)value, NULL, NULL);
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void store_release(volatile size_t *value, size_t desired)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchangePointer((void* volatile*)value, (void*)desired);
+#else
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline bool compare_exchange(volatile size_t *value, size_t *expected, size_t desired)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    void *seen = _InterlockedCompareExchangePointer((void* volatile*)value, (void*)desired, (void*)*expected);
+    if ((size_t)seen == *expected)
+        return true;
+
+    *expected = (size_t)seen;
+    return false;
+#else
+    return __atomic_compare_exchange_n(value, expected, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline size_t exchange(volatile size_t *value, size_t desired)
+{
+    size_t expected = load_acquire(value);
+    while (!compare_exchange(value, &expected, desired));
+    return expected;
+}
+
+static inline void full_fence(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    MemoryBarrier();
+#else
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+static void lock_writer(void)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&log_lock);
+#else
+    pthread_mutex_lock(&log_lock);
+#endif
+}
+
+static void unlock_writer(void)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&log_lock);
+#else
+    pthread_mutex_unlock(&log_lock);
+#endif
+}
+
+static void wake_writer(void)
+{
+    lock_writer();
+    store_release(&log_waiting, 0);
+#if defined(_WIN32)
+    WakeConditionVariable(&log_wake);
+#else
+    pthread_cond_signal(&log_wake);
+#endif
+    unlock_writer();
+}
+
+/* Called by producers after publishing: wakes the writer if it went to sleep on an empty ring. */
+static inline void notify_writer(void)
+{
+    full_fence();
+    if (load_acquire(&log_waiting))
+        wake_writer();
+}
+
+static const char* get_time(void)
 {
     time_t t = time(NULL);
-    strftime(buffer, max_size, format, localtime(&t));
+    if (t != cached_second)
+    {
+        struct tm local;
+#if defined(_WIN32)
+        localtime_s(&local, &t);
+#else
+        localtime_r(&t, &local);
+#endif
+        strftime(cached_time, TIME_BUFFER_SIZE, TIME_FORMAT, &local);
+        cached_second = t;
+    }
+
+    return cached_time;
+}
+
+/* Formats a newline-terminated line into line_buffer and returns its size. */
+static size_t format_line(enum log_level level, const char *format, va_list args)
+{
+    int prefix = snprintf(line_buffer, LOG_LINE_SIZE, LOG_FORMAT, get_time(), log_levels[level]);
+    size_t size = (prefix > 0) ? (size_t)prefix : 0;
+
+    int message = vsnprintf(line_buffer + size, LOG_LINE_SIZE - 1 - size, format, args);
+    if (message > 0)
+        size += ((size_t)message < LOG_LINE_SIZE - 2 - size) ? (size_t)message : LOG_LINE_SIZE - 2 - size;
+
+    line_buffer[size++] = '\n';
+    return size;
+}
+
+static size_t format_linef(enum log_level level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    size_t size = format_line(level, format, args);
+    va_end(args);
+
+    return size;
+}
+
+static bool push_line(enum log_level level, const char *line, size_t size)
+{
+    struct log_slot *slot;
+    size_t position = load_acquire(&log_head);
+    while (true)
+    {
+        slot = &log_slots[position & (LOG_RING_SIZE - 1)];
+        size_t sequence = load_acquire(&slot->sequence);
+        if (sequence == position)
+        {
+            if (compare_exchange(&log_head, &position, position + 1))
+                break;
+        }
+        else if (sequence < position)
+            return false;
+        else
+            position = load_acquire(&log_head);
+    }
+
+    memcpy(slot->line, line, size);
+    slot->size = size;
+    slot->level = level;
+    store_release(&slot->sequence, position + 1);
+    return true;
+}
+
+static inline bool lines_pending(void)
+{
+    struct log_slot *slot = &log_slots[log_tail & (LOG_RING_SIZE - 1)];
+    return load_acquire(&slot->sequence) == log_tail + 1 || load_acquire(&log_dropped) != 0;
+}
+
+/* Writes out every published line, returning whether there was any. */
+static bool drain_lines(const struct raku_log_sink *sink)
+{
+    bool written = false;
+    while (true)
+    {
+        struct log_slot *slot = &log_slots[log_tail & (LOG_RING_SIZE - 1)];
+        if (load_acquire(&slot->sequence) != log_tail + 1)
+            break;
+
+        sink->write(sink->ctx, slot->level, slot->line, slot->size);
+        store_release(&slot->sequence, log_tail + LOG_RING_SIZE);
+        log_tail++;
+        written = true;
+    }
+
+    size_t dropped = exchange(&log_dropped, 0);
+    if (dropped != 0)
+    {
+        size_t size = format_linef(RAKU_LOG_LEVEL_WARN, "%zu log lines dropped, the queue was full.", dropped);
+        sink->write(sink->ctx, RAKU_LOG_LEVEL_WARN, line_buffer, size);
+        written = true;
+    }
+
+    return written;
+}
+
+/* Sleeps until a producer publishes a line or raku_log_stop() is called. */
+static void wait_for_lines(void)
+{
+    lock_writer();
+    store_release(&log_waiting, 1);
+    full_fence();
+    while (load_acquire(&log_waiting) && load_acquire(&log_running) && !lines_pending())
+    {
+#if defined(_WIN32)
+        SleepConditionVariableSRW(&log_wake, &log_lock, INFINITE, 0);
+#else
+        pthread_cond_wait(&log_wake, &log_lock);
+#endif
+    }
+    store_release(&log_waiting, 0);
+    unlock_writer();
+}
+
+static void run_writer(void)
+{
+    const struct raku_log_sink *sink = (const struct raku_log_sink*)load_acquire(&log_sink);
+    while (load_acquire(&log_running))
+    {
+        if (drain_lines(sink))
+            continue;
+
+        if (sink->flush != NULL)
+            sink->flush(sink->ctx);
+        wait_for_lines();
+    }
+
+    drain_lines(sink);
+    if (sink->flush != NULL)
+        sink->flush(sink->ctx);
 }
 
+#if defined(_WIN32)
+static DWORD WINAPI writer_main(LPVOID arg)
+{
+    (void)arg;
+    run_writer();
+    return 0;
+}
+#else
+static void* writer_main(void *arg)
+{
+    (void)arg;
+    run_writer();
+    return NULL;
+}
+#endif
+
 RAKU_API
 void raku_log(enum log_level level, const char *format, ...)
 {
-    char time[TIME_BUFFER_SIZE];
-    get_time(time, TIME_BUFFER_SIZE, TIME_FORMAT);
-    printf(LOG_FORMAT, time, log_levels[level]);
-
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    size_t size = format_line(level, format, args);
     va_end(args);
 
-    fputc('\n', stdout);
+    if (!load_acquire(&log_running))
+    {
+        fwrite(line_buffer, 1, size, stdout);
+        return;
+    }
+
+    if (!push_line(level, line_buffer, size))
+    {
+        size_t dropped = load_acquire(&log_dropped);
+        while (!compare_exchange(&log_dropped, &dropped, dropped + 1));
+    }
+    notify_writer();
+}
+
+RAKU_API
+enum raku_status raku_log_start(const struct raku_log_sink *sink)
+{
+    ASSERT(sink == NULL || sink->write != NULL,
+           "raku_log_start: sink must have a write callback!");
+
+    if (load_acquire(&log_running))
+        return RAKU_OUT_OF_RANGE;
+
+    if (!load_acquire(&log_ready))
+    {
+        for (size_t i = 0; i < LOG_RING_SIZE; ++i)
+            log_slots[i].sequence = i;
+        store_release(&log_ready, 1);
+    }
+
+    if (sink != NULL)
+        log_sink_storage = *sink;
+    else
+        raku_log_sink_fd(1, &log_sink_storage);
+    store_release(&log_sink, (size_t)&log_sink_storage);
+
+    fflush(stdout);
+    store_release(&log_running, 1);
+
+#if defined(_WIN32)
+    log_writer = CreateThread(NULL, 0, writer_main, NULL, 0, NULL);
+    bool started = (log_writer != NULL);
+#else
+    bool started = (pthread_create(&log_writer, NULL, writer_main, NULL) == 0);
+#endif
+
+    if (!started)
+    {
+        store_release(&log_running, 0);
+        return RAKU_NO_MEMORY;
+    }
+
+    return RAKU_OK;
+}
+
+RAKU_API
+void raku_log_stop(void)
+{
+    if (!load_acquire(&log_running))
+        return;
+
+    store_release(&log_running, 0);
+    wake_writer();
+
+#if defined(_WIN32)
+    WaitForSingleObject(log_writer, INFINITE);
+    CloseHandle(log_writer);
+#else
+    pthread_join(log_writer, NULL);
+#endif
+
+    const struct raku_log_sink *sink = (const struct raku_log_sink*)exchange(&log_sink, 0);
+    if (sink->close != NULL)
+        sink->close(sink->ctx);
+}
+
+static void fd_write(void *ctx, enum log_level level, const char *line, size_t size)
+{
+    (void)level;
+    int fd = (int)(intptr_t)ctx;
+    while (size > 0)
+    {
+#if defined(_WIN32)
+        int written = _write(fd, line, (unsigned int)size);
+        if (written < 0)
+            return;
+#else
+        ssize_t written = write(fd, line, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+#endif
+
+        line += written;
+        size -= (size_t)written;
+    }
+}
+
+RAKU_API
+void raku_log_sink_fd(int fd, struct raku_log_sink *out)
+{
+    ASSERT(out != NULL,
+           "raku_log_sink_fd: out must not be NULL!");
+
+    out->write = fd_write;
+    out->flush = NULL;
+    out->close = NULL;
+    out->ctx = (void*)(intptr_t)fd;
+}
+
+struct file_sink
+{
+    FILE *file;
+    size_t size;
+    size_t max_size;
+    unsigned int max_files;
+    char path[LOG_PATH_SIZE];
+    char from[LOG_PATH_SIZE + 16];
+    char to[LOG_PATH_SIZE + 16];
+};
+
+static void rotate_file(struct file_sink *sink)
+{
+    fclose(sink->file);
+
+    if (sink->max_files > 0)
+    {
+        for (unsigned int i = sink->max_files; i > 1; --i)
+        {
+            snprintf(sink->from, sizeof(sink->from), "%s.%u", sink->path, i - 1);
+            snprintf(sink->to, sizeof(sink->to), "%s.%u", sink->path, i);
+            remove(sink->to);
+            rename(sink->from, sink->to);
+        }
+
+        snprintf(sink->to, sizeof(sink->to), "%s.1", sink->path);
+        remove(sink->to);
+        rename(sink->path, sink->to);
+    }
+
+    sink->file = fopen(sink->path, "wb");
+    sink->size = 0;
+}
+
+static void file_write(void *ctx, enum log_level level, const char *line, size_t size)
+{
+    (void)level;
+    struct file_sink *sink = ctx;
+    if (sink->max_size != 0 && sink->size != 0 && sink->size + size > sink->max_size)
+        rotate_file(sink);
+
+    if (sink->file == NULL)
+        return;
+
+    sink->size += fwrite(line, 1, size, sink->file);
+}
+
+static void file_flush(void *ctx)
+{
+    struct file_sink *sink = ctx;
+    if (sink->file != NULL)
+        fflush(sink->file);
+}
+
+static void file_close(void *ctx)
+{
+    struct file_sink *sink = ctx;
+    if (sink->file != NULL)
+        fclose(sink->file);
+
+    raku_free(sink, sizeof(struct file_sink));
+}
+
+RAKU_API
+enum raku_status raku_log_sink_file(const char *path, size_t max_size, unsigned int max_files, struct raku_log_sink *out)
+{
+    ASSERT(path != NULL,
+           "raku_log_sink_file: path must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_log_sink_file: out must not be NULL!");
+
+    size_t length = strnlen(path, LOG_PATH_SIZE);
+    if (length == 0 || length == LOG_PATH_SIZE)
+        return RAKU_OUT_OF_RANGE;
+
+    struct file_sink *sink;
+    enum raku_status status = raku_alloc(sizeof(struct file_sink), (void**)&sink);
+    if (status != RAKU_OK)
+        return status;
+
+    memcpy(sink->path, path, length + 1);
+    sink->file = fopen(path, "ab");
+    if (sink->file == NULL)
+    {
+        raku_free(sink, sizeof(struct file_sink));
+        return RAKU_OUT_OF_RANGE;
+    }
+
+    fseek(sink->file, 0, SEEK_END);
+    long size = ftell(sink->file);
+    sink->size = (size > 0) ? (size_t)size : 0;
+    sink->max_size = max_size;
+    sink->max_files = max_files;
+
+    out->write = file_write;
+    out->flush = file_flush;
+    out->close = file_close;
+    out->ctx = sink;
+    return RAKU_OK;
 }
\ No newline at end of file
@@ -1,14 +1,79 @@
 #include <RAKU/core/memory.h>
+#include <RAKU/debug.h>
 
 #include <stdlib.h>
 #include <string.h>
-#include <errno.h>
 
-RAKU_API
-enum raku_status raku_alloc(size_t size, void **out)
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+#define ARENA_BASE_CHUNK_SIZE 65536
+#define ARENA_ALIGNMENT 16
+
+#define ALIGN_UP(size, alignment) (((size) + ((alignment) - 1)) & ~(size_t)((alignment) - 1))
+#define ALIGN_DOWN(size, alignment) ((size) & ~(size_t)((alignment) - 1))
+
+struct raku_arena_chunk
+{
+    struct raku_arena_chunk *next;
+    size_t size;
+    size_t used;
+};
+
+#define CHUNK_HEADER_SIZE ALIGN_UP(sizeof(struct raku_arena_chunk), ARENA_ALIGNMENT)
+#define CHUNK_DATA(chunk) ((char*)(chunk) + CHUNK_HEADER_SIZE)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL _Thread_local
+#endif
+
+static void* default_alloc(void *ctx, size_t size)
 {
-    void *m = malloc(size);
-    if (m == NULL && errno == ENOMEM)
+    (void)ctx;
+    return malloc(size);
+}
+
+static void* default_realloc(void *ctx, void *block, size_t old_size, size_t new_size)
+{
+    (void)ctx;
+    (void)old_size;
+    return realloc(block, new_size);
+}
+
+static void default_free(void *ctx, void *block, size_t size)
+{
+    (void)ctx;
+    (void)size;
+    free(block);
+}
+
+static struct raku_allocator global_allocator = {
+    .alloc = default_alloc,
+    .realloc = default_realloc,
+    .free = default_free,
+    .ctx = NULL
+};
+
+static THREAD_LOCAL const struct raku_allocator *local_allocator;
+
+static inline const struct raku_allocator* current_allocator(void)
+{
+    return (local_allocator != NULL) ? local_allocator : &global_allocator;
+}
+
+static enum raku_status allocator_alloc(const struct raku_allocator *allocator, size_t size, void **out)
+{
+    void *m = allocator->alloc(allocator->ctx, size);
+    if (m == NULL && size != 0)
     {
         return RAKU_NO_MEMORY;
     }
@@ -17,27 +82,784 @@ enum raku_status raku_alloc(size_t size, void **out)
     return RAKU_OK;
 }
 
+static void allocator_free(const struct raku_allocator *allocator, void *block, size_t size)
+{
+    if (block != NULL)
+        allocator->free(allocator->ctx, block, size);
+}
+
 RAKU_API
-enum raku_status raku_realloc(void *block, size_t new_size, void **out)
+void raku_allocator_set(const struct raku_allocator *allocator)
 {
-    void *m = realloc(block, new_size);
-    if (m == NULL && errno == ENOMEM)
+    if (allocator != NULL)
+    {
+        ASSERT(allocator->alloc != NULL && allocator->realloc != NULL && allocator->free != NULL,
+               "raku_allocator_set: allocator callbacks must not be NULL!");
+
+        global_allocator = *allocator;
+    }
+    else
+    {
+        global_allocator.alloc = default_alloc;
+        global_allocator.realloc = default_realloc;
+        global_allocator.free = default_free;
+        global_allocator.ctx = NULL;
+    }
+}
+
+RAKU_API
+const struct raku_allocator* raku_allocator_set_local(const struct raku_allocator *allocator)
+{
+    ASSERT(allocator == NULL || (allocator->alloc != NULL && allocator->realloc != NULL && allocator->free != NULL),
+           "raku_allocator_set_local: allocator callbacks must not be NULL!");
+
+    const struct raku_allocator *previous = local_allocator;
+    local_allocator = allocator;
+    return previous;
+}
+
+RAKU_API
+const struct raku_allocator* raku_allocator_get(void)
+{
+    return current_allocator();
+}
+
+#if defined(RAKU_MEMORY_STATS)
+
+static struct raku_memory_stats memory_stats[RAKU_MEMORY_CATEGORIES];
+
+static inline size_t load_counter(size_t *counter)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (size_t)_InterlockedCompareExchangePointer((void* volatile*)counter, NULL, NULL);
+#else
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline size_t add_counter(size_t *counter, size_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_WIN64)
+    return (size_t)_InterlockedExchangeAdd64((volatile __int64*)counter, (__int64)value) + value;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    return (size_t)_InterlockedExchangeAdd((volatile long*)counter, (long)value) + value;
+#else
+    return __atomic_add_fetch(counter, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void raise_peak(size_t *peak, size_t live)
+{
+    size_t current = load_counter(peak);
+    while (live > current)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        void *seen = _InterlockedCompareExchangePointer((void* volatile*)peak, (void*)live, (void*)current);
+        if ((size_t)seen == current)
+            break;
+        current = (size_t)seen;
+#else
+        if (__atomic_compare_exchange_n(peak, &current, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            break;
+#endif
+    }
+}
+
+static void count_alloc(enum raku_memory_category category, size_t size)
+{
+    struct raku_memory_stats *stats = &memory_stats[category];
+    add_counter(&stats->allocations, 1);
+    raise_peak(&stats->peak, add_counter(&stats->live, size));
+}
+
+static void count_realloc(enum raku_memory_category category, size_t old_size, size_t new_size)
+{
+    struct raku_memory_stats *stats = &memory_stats[category];
+    add_counter(&stats->reallocations, 1);
+    if (new_size >= old_size)
+        raise_peak(&stats->peak, add_counter(&stats->live, new_size - old_size));
+    else
+        add_counter(&stats->live, (size_t)0 - (old_size - new_size));
+}
+
+static void count_free(enum raku_memory_category category, size_t size)
+{
+    add_counter(&memory_stats[category].live, (size_t)0 - size);
+}
+
+#else
+
+#define count_alloc(category, size) ((void)0)
+#define count_realloc(category, old_size, new_size) ((void)0)
+#define count_free(category, size) ((void)0)
+
+#endif
+
+RAKU_API
+enum raku_status raku_alloc(size_t size, void **out)
+{
+    return raku_alloc_for(RAKU_MEMORY_OTHER, size, out);
+}
+
+RAKU_API
+enum raku_status raku_realloc(void *block, size_t old_size, size_t new_size, void **out)
+{
+    return raku_realloc_for(RAKU_MEMORY_OTHER, block, old_size, new_size, out);
+}
+
+RAKU_API
+void raku_free(void *block, size_t size)
+{
+    raku_free_for(RAKU_MEMORY_OTHER, block, size);
+}
+
+RAKU_API
+enum raku_status raku_alloc_for(enum raku_memory_category category, size_t size, void **out)
+{
+    enum raku_status status = allocator_alloc(current_allocator(), size, out);
+    if (status == RAKU_OK)
+        count_alloc(category, size);
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_realloc_for(enum raku_memory_category category, void *block, size_t old_size, size_t new_size, void **out)
+{
+    if (block == NULL)
+        return raku_alloc_for(category, new_size, out);
+
+    const struct raku_allocator *allocator = current_allocator();
+    void *m = allocator->realloc(allocator->ctx, block, old_size, new_size);
+    if (m == NULL && new_size != 0)
     {
         return RAKU_NO_MEMORY;
     }
 
+    count_realloc(category, old_size, new_size);
     *out = m;
     return RAKU_OK;
 }
 
 RAKU_API
-void raku_free(void *block)
+void raku_free_for(enum raku_memory_category category, void *block, size_t size)
 {
-    free(block);
+    if (block == NULL)
+        return;
+
+    allocator_free(current_allocator(), block, size);
+    count_free(category, size);
+}
+
+RAKU_API
+void raku_memory_stats(struct raku_memory_stats *out)
+{
+    ASSERT(out != NULL,
+           "raku_memory_stats: out must not be NULL!");
+
+    for (int i = 0; i < RAKU_MEMORY_CATEGORIES; ++i)
+    {
+#if defined(RAKU_MEMORY_STATS)
+        out[i].live = load_counter(&memory_stats[i].live);
+        out[i].peak = load_counter(&memory_stats[i].peak);
+        out[i].allocations = load_counter(&memory_stats[i].allocations);
+        out[i].reallocations = load_counter(&memory_stats[i].reallocations);
+#else
+        out[i].live = 0;
+        out[i].peak = 0;
+        out[i].allocations = 0;
+        out[i].reallocations = 0;
+#endif
+    }
 }
 
 RAKU_API
 void raku_zero_memory(void *block, size_t size)
 {
     memset(block, 0, size);
+}
+
+/*
+ * Slabs are laid out in pages whose first block points back to the slab, so
+ * a freed block finds its slab, and through it the pool that carved it.
+ * Every size class divides the page size.
+ */
+#define POOL_SLAB_SIZE 32768
+#define POOL_PAGE_SIZE 4096
+
+struct pool_block
+{
+    struct pool_block *next;
+};
+
+struct pool_slab
+{
+    struct pool_slab *next;
+    struct pool_slab *prev;
+    struct pool *owner;
+    struct pool_block *free;
+    char *cursor;
+    char *end;
+    size_t used;
+    size_t capacity;
+};
+
+/*
+ * Slabs with blocks left come first, full ones last. Other threads push the
+ * blocks they free on remote, which the pool takes back once it runs out.
+ */
+struct pool
+{
+    struct pool_slab *first;
+    struct pool_slab *last;
+    volatile size_t remote;
+    size_t block_size;
+    size_t slabs;
+    struct pool_heap *heap;
+};
+
+/* The pools a thread carves from the slabs of one allocator. */
+struct pool_heap
+{
+    struct pool_heap *next;
+    const struct raku_allocator *key;
+    struct raku_allocator allocator;
+    struct pool pools[RAKU_POOL_CLASSES];
+};
+
+static const size_t pool_block_sizes[RAKU_POOL_CLASSES] = { 8, 16, 32, 64 };
+static THREAD_LOCAL struct pool_heap *heaps;
+
+/* Heaps of exited threads with blocks still out, left for the next thread to adopt. */
+static volatile size_t abandoned_heaps;
+
+static inline size_t load_acquire(volatile size_t *value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (size_t)_InterlockedCompareExchangePointer((void* volatile*)value, NULL, NULL);
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline bool compare_exchange(volatile size_t *value, size_t *expected, size_t desired)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    void *seen = _InterlockedCompareExchangePointer((void* volatile*)value, (void*)desired, (void*)*expected);
+    if ((size_t)seen == *expected)
+        return true;
+
+    *expected = (size_t)seen;
+    return false;
+#else
+    return __atomic_compare_exchange_n(value, expected, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline size_t exchange(volatile size_t *value, size_t desired)
+{
+    size_t expected = load_acquire(value);
+    while (!compare_exchange(value, &expected, desired));
+    return expected;
+}
+
+static inline bool same_allocator(const struct raku_allocator *allocator, const struct raku_allocator *other)
+{
+    return
+        allocator->alloc == other->alloc &&
+        allocator->realloc == other->realloc &&
+        allocator->free == other->free &&
+        allocator->ctx == other->ctx;
+}
+
+static inline int pool_class(size_t size)
+{
+    if (size <= 8)
+        return 0;
+    else if (size <= 16)
+        return 1;
+    else if (size <= 32)
+        return 2;
+    else if (size <= 64)
+        return 3;
+    else
+        return -1;
+}
+
+static inline struct pool_slab* slab_of(void *block)
+{
+    return *(struct pool_slab**)ALIGN_DOWN((uintptr_t)block, POOL_PAGE_SIZE);
+}
+
+static inline bool slab_full(const struct pool_slab *slab)
+{
+    return slab->free == NULL && slab->cursor == slab->end;
+}
+
+static void unlink_slab(struct pool *pool, struct pool_slab *slab)
+{
+    if (slab->prev != NULL)
+        slab->prev->next = slab->next;
+    else
+        pool->first = slab->next;
+
+    if (slab->next != NULL)
+        slab->next->prev = slab->prev;
+    else
+        pool->last = slab->prev;
+}
+
+static void push_slab(struct pool *pool, struct pool_slab *slab, bool front)
+{
+    if (front)
+    {
+        slab->prev = NULL;
+        slab->next = pool->first;
+        if (pool->first != NULL)
+            pool->first->prev = slab;
+        else
+            pool->last = slab;
+        pool->first = slab;
+    }
+    else
+    {
+        slab->next = NULL;
+        slab->prev = pool->last;
+        if (pool->last != NULL)
+            pool->last->next = slab;
+        else
+            pool->first = slab;
+        pool->last = slab;
+    }
+}
+
+static enum raku_status add_slab(struct pool *pool)
+{
+    char *memory;
+    enum raku_status status = allocator_alloc(&pool->heap->allocator, POOL_SLAB_SIZE, (void**)&memory);
+    if (status != RAKU_OK)
+        return status;
+    count_alloc(RAKU_MEMORY_POOL_SLABS, POOL_SLAB_SIZE);
+
+    struct pool_slab *slab = (struct pool_slab*)memory;
+    char *first = (char*)ALIGN_UP((uintptr_t)(slab + 1), POOL_PAGE_SIZE);
+    char *end = (char*)ALIGN_DOWN((uintptr_t)(memory + POOL_SLAB_SIZE), POOL_PAGE_SIZE);
+
+    *(struct pool_slab**)first = slab;
+    slab->owner = pool;
+    slab->free = NULL;
+    slab->cursor = first + pool->block_size;
+    slab->end = end;
+    slab->used = 0;
+    slab->capacity = ((size_t)(end - first) / POOL_PAGE_SIZE) * (POOL_PAGE_SIZE / pool->block_size - 1);
+
+    push_slab(pool, slab, true);
+    pool->slabs++;
+    return RAKU_OK;
+}
+
+static void release_slab(struct pool *pool, struct pool_slab *slab)
+{
+    unlink_slab(pool, slab);
+    pool->slabs--;
+    count_free(RAKU_MEMORY_POOL_SLABS, POOL_SLAB_SIZE);
+    allocator_free(&pool->heap->allocator, slab, POOL_SLAB_SIZE);
+}
+
+/*
+ * Puts block back in its slab, on the thread that owns the pool. Only the
+ * first slab is kept when it empties, any other goes back to the allocator.
+ */
+static void return_block(struct pool *pool, struct pool_slab *slab, struct pool_block *block)
+{
+    bool full = slab_full(slab);
+    block->next = slab->free;
+    slab->free = block;
+    slab->used--;
+
+    struct pool_slab *first = pool->first;
+    if (slab == first)
+        return;
+
+    if (slab->used == 0)
+        release_slab(pool, slab);
+    else if (full)
+    {
+        unlink_slab(pool, slab);
+        push_slab(pool, slab, true);
+        if (first->used == 0)
+            release_slab(pool, first);
+    }
+}
+
+static void collect_remote(struct pool *pool)
+{
+    struct pool_block *block = (struct pool_block*)exchange(&pool->remote, 0);
+    while (block != NULL)
+    {
+        struct pool_block *next = block->next;
+        return_block(pool, slab_of(block), block);
+        block = next;
+    }
+}
+
+static void push_abandoned(struct pool_heap *heap)
+{
+    size_t head = load_acquire(&abandoned_heaps);
+    do
+        heap->next = (struct pool_heap*)head;
+    while (!compare_exchange(&abandoned_heaps, &head, (size_t)heap));
+}
+
+/*
+ * Runs when a thread exits: empty slabs go back to their allocator, and a
+ * heap with blocks still out is left for another thread to adopt.
+ */
+static void abandon_heaps(void *list)
+{
+    heaps = NULL;
+
+    struct pool_heap *heap = list;
+    while (heap != NULL)
+    {
+        struct pool_heap *next = heap->next;
+
+        bool empty = true;
+        for (int i = 0; i < RAKU_POOL_CLASSES; ++i)
+        {
+            struct pool *pool = &heap->pools[i];
+            collect_remote(pool);
+
+            struct pool_slab *slab = pool->first;
+            while (slab != NULL)
+            {
+                struct pool_slab *next_slab = slab->next;
+                if (slab->used == 0)
+                    release_slab(pool, slab);
+                slab = next_slab;
+            }
+
+            empty = empty && (pool->first == NULL);
+        }
+
+        if (empty)
+        {
+            struct raku_allocator allocator = heap->allocator;
+            count_free(RAKU_MEMORY_POOL_SLABS, sizeof(struct pool_heap));
+            allocator_free(&allocator, heap, sizeof(struct pool_heap));
+        }
+        else
+            push_abandoned(heap);
+
+        heap = next;
+    }
+}
+
+#if defined(_WIN32)
+
+static DWORD heap_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE heap_key_once = INIT_ONCE_STATIC_INIT;
+
+static void NTAPI release_heaps(void *list)
+{
+    if (list != NULL)
+        abandon_heaps(list);
+}
+
+static BOOL CALLBACK create_heap_key(PINIT_ONCE once, void *parameter, void **context)
+{
+    (void)once;
+    (void)parameter;
+    (void)context;
+    heap_key = FlsAlloc(release_heaps);
+    return TRUE;
+}
+
+static void watch_thread_exit(void)
+{
+    InitOnceExecuteOnce(&heap_key_once, create_heap_key, NULL, NULL);
+    if (heap_key != FLS_OUT_OF_INDEXES)
+        FlsSetValue(heap_key, heaps);
+}
+
+#else
+
+static pthread_key_t heap_key;
+static pthread_once_t heap_key_once = PTHREAD_ONCE_INIT;
+static bool heap_key_ready;
+
+static void create_heap_key(void)
+{
+    heap_key_ready = (pthread_key_create(&heap_key, abandon_heaps) == 0);
+}
+
+static void watch_thread_exit(void)
+{
+    pthread_once(&heap_key_once, create_heap_key);
+    if (heap_key_ready)
+        pthread_setspecific(heap_key, heaps);
+}
+
+#endif
+
+static struct pool_heap* find_heap(const struct raku_allocator *allocator)
+{
+    for (struct pool_heap *heap = heaps; heap != NULL; heap = heap->next)
+    {
+        if (heap->key == allocator && same_allocator(&heap->allocator, allocator))
+            return heap;
+    }
+
+    return NULL;
+}
+
+static struct pool_heap* adopt_heap(const struct raku_allocator *allocator)
+{
+    struct pool_heap *found = NULL;
+    struct pool_heap *heap = (struct pool_heap*)exchange(&abandoned_heaps, 0);
+    while (heap != NULL)
+    {
+        struct pool_heap *next = heap->next;
+        if (found == NULL && heap->key == allocator && same_allocator(&heap->allocator, allocator))
+            found = heap;
+        else
+            push_abandoned(heap);
+        heap = next;
+    }
+
+    return found;
+}
+
+static enum raku_status create_heap(const struct raku_allocator *allocator, struct pool_heap **out)
+{
+    struct pool_heap *heap = adopt_heap(allocator);
+    if (heap == NULL)
+    {
+        enum raku_status status = allocator_alloc(allocator, sizeof(struct pool_heap), (void**)&heap);
+        if (status != RAKU_OK)
+            return status;
+        count_alloc(RAKU_MEMORY_POOL_SLABS, sizeof(struct pool_heap));
+
+        heap->key = allocator;
+        heap->allocator = *allocator;
+        for (int i = 0; i < RAKU_POOL_CLASSES; ++i)
+        {
+            struct pool *pool = &heap->pools[i];
+            pool->first = NULL;
+            pool->last = NULL;
+            pool->remote = 0;
+            pool->block_size = pool_block_sizes[i];
+            pool->slabs = 0;
+            pool->heap = heap;
+        }
+    }
+
+    heap->next = heaps;
+    heaps = heap;
+    watch_thread_exit();
+
+    *out = heap;
+    return RAKU_OK;
+}
+
+RAKU_API
+enum raku_status raku_pool_alloc(size_t size, void **out)
+{
+    int index = pool_class(size);
+    if (index < 0)
+        return raku_alloc_for(RAKU_MEMORY_NODES, size, out);
+
+    enum raku_status status;
+    const struct raku_allocator *allocator = current_allocator();
+    struct pool_heap *heap = find_heap(allocator);
+    if (heap == NULL)
+    {
+        status = create_heap(allocator, &heap);
+        if (status != RAKU_OK)
+            return status;
+    }
+
+    struct pool *pool = &heap->pools[index];
+    struct pool_slab *slab = pool->first;
+    if (slab == NULL || slab_full(slab))
+    {
+        collect_remote(pool);
+
+        slab = pool->first;
+        if (slab == NULL || slab_full(slab))
+        {
+            status = add_slab(pool);
+            if (status != RAKU_OK)
+                return status;
+            slab = pool->first;
+        }
+    }
+
+    struct pool_block *block = slab->free;
+    if (block != NULL)
+        slab->free = block->next;
+    else
+    {
+        /* Carve the next block, stepping over the back pointer of a new page. */
+        block = (struct pool_block*)slab->cursor;
+        slab->cursor += pool->block_size;
+        if (slab->cursor != slab->end && ((uintptr_t)slab->cursor & (POOL_PAGE_SIZE - 1)) == 0)
+        {
+            *(struct pool_slab**)slab->cursor = slab;
+            slab->cursor += pool->block_size;
+        }
+    }
+
+    slab->used++;
+    if (slab_full(slab) && slab != pool->last)
+    {
+        unlink_slab(pool, slab);
+        push_slab(pool, slab, false);
+    }
+
+    *out = block;
+    return RAKU_OK;
+}
+
+RAKU_API
+void raku_pool_free(void *block, size_t size)
+{
+    if (block == NULL)
+        return;
+
+    int index = pool_class(size);
+    if (index < 0)
+    {
+        raku_free_for(RAKU_MEMORY_NODES, block, size);
+        return;
+    }
+
+    struct pool_slab *slab = slab_of(block);
+    struct pool *pool = slab->owner;
+    ASSERT(pool->block_size == pool_block_sizes[index],
+           "raku_pool_free: block was allocated with another size.");
+
+    for (struct pool_heap *heap = heaps; heap != NULL; heap = heap->next)
+    {
+        if (heap == pool->heap)
+        {
+            return_block(pool, slab, block);
+            return;
+        }
+    }
+
+    size_t head = load_acquire(&pool->remote);
+    do
+        ((struct pool_block*)block)->next = (struct pool_block*)head;
+    while (!compare_exchange(&pool->remote, &head, (size_t)block));
+}
+
+RAKU_API
+void raku_pool_get_stats(struct raku_pool_stats *out)
+{
+    ASSERT(out != NULL,
+           "raku_pool_get_stats: out must not be NULL!");
+
+    struct pool_heap *heap = find_heap(current_allocator());
+    for (int i = 0; i < RAKU_POOL_CLASSES; ++i)
+    {
+        out[i].block_size = pool_block_sizes[i];
+        out[i].slabs = 0;
+        out[i].blocks = 0;
+        out[i].free = 0;
+        if (heap == NULL)
+            continue;
+
+        struct pool *pool = &heap->pools[i];
+        out[i].slabs = pool->slabs;
+        for (struct pool_slab *slab = pool->first; slab != NULL; slab = slab->next)
+        {
+            out[i].blocks += slab->used;
+            out[i].free += slab->capacity - slab->used;
+        }
+    }
+}
+
+RAKU_API
+void raku_arena_init(struct raku_arena *arena, size_t chunk_size)
+{
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->chunk_size =
+        (chunk_size == 0) ?
+            ARENA_BASE_CHUNK_SIZE :
+            ALIGN_UP(chunk_size, ARENA_ALIGNMENT);
+    arena->allocator = current_allocator();
+}
+
+RAKU_API
+enum raku_status raku_arena_alloc(struct raku_arena *arena, size_t size, void **out)
+{
+    size = ALIGN_UP(size, ARENA_ALIGNMENT);
+
+    struct raku_arena_chunk *chunk = arena->current;
+    struct raku_arena_chunk *last = chunk;
+    while (chunk != NULL)
+    {
+        if (chunk->size - chunk->used >= size)
+        {
+            *out = CHUNK_DATA(chunk) + chunk->used;
+            chunk->used += size;
+            arena->current = chunk;
+            return RAKU_OK;
+        }
+
+        /* Chunks past the current one are left over from before the last
+           reset and are recycled as the arena reaches them. */
+        last = chunk;
+        chunk = chunk->next;
+        if (chunk != NULL)
+            chunk->used = 0;
+    }
+
+    size_t chunk_size = (size > arena->chunk_size) ? size : arena->chunk_size;
+    if (chunk_size > SIZE_MAX - CHUNK_HEADER_SIZE)
+        return RAKU_NO_MEMORY;
+
+    enum raku_status status = allocator_alloc(arena->allocator, CHUNK_HEADER_SIZE + chunk_size, (void**)&chunk);
+    if (status != RAKU_OK)
+        return status;
+    count_alloc(RAKU_MEMORY_ARENAS, CHUNK_HEADER_SIZE + chunk_size);
+
+    chunk->next = NULL;
+    chunk->size = chunk_size;
+    chunk->used = size;
+
+    if (last != NULL)
+        last->next = chunk;
+    else
+        arena->first = chunk;
+    arena->current = chunk;
+
+    *out = CHUNK_DATA(chunk);
+    return RAKU_OK;
+}
+
+RAKU_API
+void raku_arena_reset(struct raku_arena *arena)
+{
+    arena->current = arena->first;
+    if (arena->current != NULL)
+        arena->current->used = 0;
+}
+
+RAKU_API
+void raku_arena_free(struct raku_arena *arena)
+{
+    struct raku_arena_chunk *chunk = arena->first;
+    while (chunk != NULL)
+    {
+        struct raku_arena_chunk *next = chunk->next;
+        count_free(RAKU_MEMORY_ARENAS, CHUNK_HEADER_SIZE + chunk->size);
+        allocator_free(arena->allocator, chunk, CHUNK_HEADER_SIZE + chunk->size);
+        chunk = next;
+    }
+
+    arena->first = NULL;
+    arena->current = NULL;
 }
\ No newline at end of file
@@ -24,6 +24,8 @@ const char* raku_status_to_string(enum raku_status status)
         STATUS_CASE(RAKU_JSON_MISSING_PRECISION, "(JSON) Missing floating precision.")
         STATUS_CASE(RAKU_JSON_MISSING_EXPONENT, "(JSON) Missing exponent.")
         STATUS_CASE(RAKU_JSON_EXPECTED_END, "(JSON) Expected end of value.")
+        STATUS_CASE(RAKU_JSON_INVALID_SNOWFLAKE, "(JSON) Invalid snowflake.")
+        STATUS_CASE(RAKU_JSON_INCOMPLETE, "(JSON) Incomplete document.")
     }
     return NULL;
 
@@ -0,0 +1,287 @@
+#include "json_atoms.h"
+
+#include <RAKU/core/memory.h>
+#include <RAKU/debug.h>
+
+#include <limits.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+/* The table is never more than half full, so probe sequences stay short. */
+#define ATOM_TABLE_SIZE 4096
+#define ATOM_LIMIT (ATOM_TABLE_SIZE / 2)
+#define ATOM_MAX_LENGTH 48
+
+/*
+ * Slots are filled once and only cleared by raku_json_atom_free_all(), so
+ * lookups only need to see a published atom whole, and inserts race on a
+ * compare-and-swap of the slot. An insert reserves its place in atom_count
+ * first, so racing inserts cannot go past ATOM_LIMIT.
+ */
+static struct json_atom *atom_table[ATOM_TABLE_SIZE];
+static unsigned int atom_count;
+
+static inline struct json_atom* load_slot(struct json_atom **slot)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (struct json_atom*)_InterlockedCompareExchangePointer((void* volatile*)slot, NULL, NULL);
+#else
+    return __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline bool publish_slot(struct json_atom **slot, struct json_atom *atom)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _InterlockedCompareExchangePointer((void* volatile*)slot, atom, NULL) == NULL;
+#else
+    struct json_atom *expected = NULL;
+    return __atomic_compare_exchange_n(slot, &expected, atom, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline struct json_atom* take_slot(struct json_atom **slot)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (struct json_atom*)_InterlockedExchangePointer((void* volatile*)slot, NULL);
+#else
+    return __atomic_exchange_n(slot, NULL, __ATOMIC_ACQ_REL);
+#endif
+}
+
+static inline unsigned int load_count(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (unsigned int)_InterlockedCompareExchange((volatile long*)&atom_count, 0, 0);
+#else
+    return __atomic_load_n(&atom_count, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void release_count(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedDecrement((volatile long*)&atom_count);
+#else
+    __atomic_sub_fetch(&atom_count, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+/* Takes a place for one more atom, or returns false when the table is at its limit. */
+static inline bool reserve_count(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned int count = (unsigned int)_InterlockedIncrement((volatile long*)&atom_count);
+#else
+    unsigned int count = __atomic_add_fetch(&atom_count, 1, __ATOMIC_RELAXED);
+#endif
+    if (count > ATOM_LIMIT)
+    {
+        release_count();
+        return false;
+    }
+
+    return true;
+}
+
+static inline void reset_count(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchange((volatile long*)&atom_count, 0);
+#else
+    __atomic_store_n(&atom_count, 0, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline size_t atom_size(unsigned int count)
+{
+    return sizeof(struct json_atom) + count + 1;
+}
+
+static enum raku_status create_atom(
+    const char *chars,
+    unsigned int count,
+    string_hash hash,
+    struct raku_arena *arena,
+    struct json_atom **out)
+{
+    struct json_atom *atom;
+    size_t size = atom_size(count);
+    enum raku_status status =
+        (arena != NULL) ?
+            raku_arena_alloc(arena, size, (void**)&atom) :
+            raku_alloc_for(RAKU_MEMORY_NODES, size, (void**)&atom);
+
+    if (status == RAKU_OK)
+    {
+        atom->_header.type = RAKU_JSON_KEY;
+        atom->_header.flags = (arena != NULL) ? RAKU_JSON_FLAG_ARENA : 0;
+        atom->count = count;
+        atom->hash = hash;
+        if (count > 0)
+            memcpy(atom->chars, chars, count);
+        atom->chars[count] = '\0';
+
+        *out = atom;
+    }
+
+    return status;
+}
+
+static inline bool atom_equal(const struct json_atom *atom, const char *chars, unsigned int count, string_hash hash)
+{
+    return
+        (atom->hash == hash) &&
+        (atom->count == count) &&
+        (memcmp(atom->chars, chars, count) == 0);
+}
+
+/* Returns the interned atom for chars, or NULL. */
+static struct json_atom* find_atom(const char *chars, unsigned int count, string_hash hash)
+{
+    unsigned int index = hash & (ATOM_TABLE_SIZE - 1);
+    while (true)
+    {
+        struct json_atom *atom = load_slot(&atom_table[index]);
+        if (atom == NULL || atom_equal(atom, chars, count, hash))
+            return atom;
+
+        index = (index + 1) & (ATOM_TABLE_SIZE - 1);
+    }
+}
+
+/*
+ * Finds or interns chars. Returns RAKU_OUT_OF_RANGE when chars is not
+ * interned yet and the table is full.
+ */
+static enum raku_status intern_atom(
+    const char *chars,
+    unsigned int count,
+    string_hash hash,
+    struct json_atom **out)
+{
+    struct json_atom *created = NULL;
+    unsigned int index = hash & (ATOM_TABLE_SIZE - 1);
+    while (true)
+    {
+        struct json_atom *atom = load_slot(&atom_table[index]);
+        if (atom == NULL)
+        {
+            if (created == NULL)
+            {
+                if (!reserve_count())
+                    return RAKU_OUT_OF_RANGE;
+
+                enum raku_status status = create_atom(chars, count, hash, NULL, &created);
+                if (status != RAKU_OK)
+                {
+                    release_count();
+                    return status;
+                }
+                created->_header.flags |= RAKU_JSON_FLAG_INTERNED;
+            }
+
+            if (publish_slot(&atom_table[index], created))
+            {
+                *out = created;
+                return RAKU_OK;
+            }
+
+            /* Another thread filled the slot first: look at what it put there. */
+            continue;
+        }
+
+        if (atom_equal(atom, chars, count, hash))
+        {
+            if (created != NULL)
+            {
+                raku_free_for(RAKU_MEMORY_NODES, created, atom_size(count));
+                release_count();
+            }
+            *out = atom;
+            return RAKU_OK;
+        }
+
+        index = (index + 1) & (ATOM_TABLE_SIZE - 1);
+    }
+}
+
+RAKU_LOCAL
+enum raku_status raku_json_atom_acquire(
+    const char *chars,
+    unsigned int count,
+    string_hash hash,
+    struct raku_arena *arena,
+    struct json_atom **out)
+{
+    if (count != 0 && count <= ATOM_MAX_LENGTH && load_count() != 0)
+    {
+        struct json_atom *atom = find_atom(chars, count, hash);
+        if (atom != NULL)
+        {
+            *out = atom;
+            return RAKU_OK;
+        }
+    }
+
+    return create_atom(chars, count, hash, arena, out);
+}
+
+RAKU_API
+enum raku_status raku_json_atom_intern(const char *key, const struct json_atom **out)
+{
+    ASSERT(key != NULL,
+           "raku_json_atom_intern: key must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_atom_intern: out must not be NULL!");
+
+    size_t size = strnlen(key, UINT_MAX);
+    if (size == 0 || size > ATOM_MAX_LENGTH)
+        return RAKU_OUT_OF_RANGE;
+
+    unsigned int count = (unsigned int)size;
+    return intern_atom(key, count, raku_json_hash(key, count), (struct json_atom**)out);
+}
+
+RAKU_API
+enum raku_status raku_json_atom_seed(const char *const *keys, unsigned int count)
+{
+    ASSERT(keys != NULL || count == 0,
+           "raku_json_atom_seed: keys must not be NULL!");
+
+    enum raku_status status = RAKU_OK;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const struct json_atom *atom;
+        status = raku_json_atom_intern(keys[i], &atom);
+        if (status != RAKU_OK)
+            break;
+    }
+
+    return status;
+}
+
+RAKU_API
+void raku_json_atom_free_all(void)
+{
+    for (unsigned int i = 0; i < ATOM_TABLE_SIZE; ++i)
+    {
+        struct json_atom *atom = take_slot(&atom_table[i]);
+        if (atom != NULL)
+            raku_free_for(RAKU_MEMORY_NODES, atom, atom_size(atom->count));
+    }
+
+    reset_count();
+}
+
+RAKU_API
+const char* raku_json_atom_get(const struct json_atom *atom)
+{
+    ASSERT(atom != NULL && atom->_header.type == RAKU_JSON_KEY,
+           "raku_json_atom_get: invalid atom.");
+
+    return atom->chars;
+}
\ No newline at end of file
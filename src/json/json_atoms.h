@@ -0,0 +1,34 @@
+#ifndef RAKU_JSON_ATOMS_H
+#define RAKU_JSON_ATOMS_H
+
+#include "json_values.h"
+
+/*
+ * An object key. Atoms carry a value header of type RAKU_JSON_KEY so the
+ * parser can keep them on its value stack, and raku_json_value_free()
+ * releases them: interned atoms are shared by every object and only freed
+ * by raku_json_atom_free_all(), the others belong to the one object
+ * holding them.
+ */
+struct json_atom
+{
+    struct json_value _header;
+    unsigned int count;
+    string_hash hash;
+    char chars[];
+};
+
+/*
+ * Returns the interned atom for chars, whose raku_json_hash() is hash, or
+ * else a new atom owned by the caller, allocated from arena when it is not
+ * NULL. Keys are only interned by raku_json_atom_intern(), never here.
+ */
+RAKU_LOCAL
+enum raku_status raku_json_atom_acquire(
+    const char *chars,
+    unsigned int count,
+    string_hash hash,
+    struct raku_arena *arena,
+    struct json_atom **out);
+
+#endif
\ No newline at end of file
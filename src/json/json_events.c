@@ -0,0 +1,201 @@
+#include <RAKU/json.h>
+#include "json_parse.h"
+#include "json_number.h"
+#include <RAKU/debug.h>
+
+#include <string.h>
+
+#define ERROR(c, r) ((struct json_error) { .column = (c), .row = (r) })
+
+#define EMIT(handler, callback, ...) \
+    (((handler)->callback != NULL) ? (handler)->callback(__VA_ARGS__) : RAKU_OK)
+
+struct event_parser
+{
+    struct json_parser parser;
+    const struct json_handler *handler;
+    void *context;
+};
+
+static enum raku_status parse_event_value(struct event_parser *events);
+
+static enum raku_status parse_event_string(struct event_parser *events, bool key)
+{
+    struct raku_string string;
+    enum raku_status status = json_parser_decode_string(&events->parser, &string);
+    if (status != RAKU_OK)
+        return status;
+
+    return key ?
+        EMIT(events->handler, on_key, events->context, &string) :
+        EMIT(events->handler, on_string, events->context, &string);
+}
+
+static enum raku_status parse_event_array(struct event_parser *events)
+{
+    struct lexer *lexer = &events->parser.lexer;
+
+    enum raku_status status = EMIT(events->handler, on_array_start, events->context);
+    if (status != RAKU_OK)
+        return status;
+
+    skip_whitespaces(lexer);
+    if (peek(lexer) != ']')
+    {
+        do
+        {
+            status = parse_event_value(events);
+            if (status != RAKU_OK)
+                return status;
+
+            skip_whitespaces(lexer);
+        } while (peek(lexer) == ',' && advance(lexer));
+    }
+
+    if (peek(lexer) != ']')
+        return RAKU_JSON_UNEXPECTED_SYMBOL;
+    advance(lexer);
+
+    return EMIT(events->handler, on_array_end, events->context);
+}
+
+static enum raku_status parse_event_object(struct event_parser *events)
+{
+    struct lexer *lexer = &events->parser.lexer;
+
+    enum raku_status status = EMIT(events->handler, on_object_start, events->context);
+    if (status != RAKU_OK)
+        return status;
+
+    skip_whitespaces(lexer);
+    if (peek(lexer) != '}')
+    {
+        do
+        {
+            skip_whitespaces(lexer);
+            if (peek(lexer) != '"')
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+            advance(lexer);
+
+            status = parse_event_string(events, true);
+            if (status != RAKU_OK)
+                return status;
+
+            skip_whitespaces(lexer);
+            if (peek(lexer) != ':')
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+            advance(lexer);
+
+            status = parse_event_value(events);
+            if (status != RAKU_OK)
+                return status;
+
+            skip_whitespaces(lexer);
+        } while (peek(lexer) == ',' && advance(lexer));
+    }
+
+    if (peek(lexer) != '}')
+        return RAKU_JSON_UNEXPECTED_SYMBOL;
+    advance(lexer);
+
+    return EMIT(events->handler, on_object_end, events->context);
+}
+
+static enum raku_status parse_event_value(struct event_parser *events)
+{
+    struct lexer *lexer = &events->parser.lexer;
+    skip_whitespaces(lexer);
+
+    switch (advance(lexer))
+    {
+        case 'n':
+            if (!is_word(lexer->current, 3, "ull"))
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+            lexer->current += 3;
+            lexer->column += 3;
+            return EMIT(events->handler, on_null, events->context);
+        case 'f':
+            if (!is_word(lexer->current, 4, "alse"))
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+            lexer->current += 4;
+            lexer->column += 4;
+            return EMIT(events->handler, on_bool, events->context, false);
+        case 't':
+            if (!is_word(lexer->current, 3, "rue"))
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+            lexer->current += 3;
+            lexer->column += 3;
+            return EMIT(events->handler, on_bool, events->context, true);
+        case '"':
+            return parse_event_string(events, false);
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '-':
+        {
+            const char *end;
+            struct json_number number;
+            enum raku_status status = raku_json_number_read(lexer->start, &end, &number);
+
+            lexer->column += (unsigned int)(end - lexer->current);
+            lexer->current = end;
+            if (status != RAKU_OK)
+                return status;
+
+            number._header.type = RAKU_JSON_NUMBER;
+            number._header.flags = 0;
+            return EMIT(events->handler, on_number, events->context, &number);
+        }
+        case '[':
+            return parse_event_array(events);
+        case '{':
+            return parse_event_object(events);
+        default:
+            return RAKU_JSON_UNEXPECTED_SYMBOL;
+    }
+}
+
+RAKU_API
+enum raku_status raku_json_parse_events(
+    const char *src,
+    const struct json_handler *handler,
+    void *context,
+    struct json_error *err)
+{
+    ASSERT(src != NULL,
+           "raku_json_parse_events: src must not be NULL!");
+    ASSERT(handler != NULL,
+           "raku_json_parse_events: handler must not be NULL!");
+    ASSERT(err != NULL,
+           "raku_json_parse_events: err must not be NULL!");
+
+    struct event_parser events = {
+        .handler = handler,
+        .context = context
+    };
+    json_parser_init(&events.parser, src, RAKU_JSON_PARSE_DEFAULT, NULL);
+
+    enum raku_status status = parse_event_value(&events);
+    if (status == RAKU_OK)
+    {
+        skip_whitespaces(&events.parser.lexer);
+        if (!at_end(&events.parser.lexer))
+            status = RAKU_JSON_EXPECTED_END;
+    }
+
+    if (status != RAKU_OK)
+        *err = ERROR(events.parser.lexer.column, events.parser.lexer.row);
+
+    json_parser_free(&events.parser);
+    return status;
+}
\ No newline at end of file
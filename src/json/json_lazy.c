@@ -0,0 +1,472 @@
+#include <RAKU/json.h>
+#include "json_parse.h"
+#include "json_number.h"
+#include <RAKU/debug.h>
+
+#include <string.h>
+
+static inline const char* skip_blanks(const char *c)
+{
+    if (!is_whitespace(*c))
+        return c;
+
+    struct json_scan_lines lines = { .count = 0, .last = NULL };
+    return raku_json_scan_whitespaces(c, &lines);
+}
+
+static enum raku_status check_value(const char *c)
+{
+    switch (*c)
+    {
+        case 'n':
+        case 'f':
+        case 't':
+        case '"':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '-':
+        case '[':
+        case '{':
+            return RAKU_OK;
+        default:
+            return RAKU_JSON_UNEXPECTED_SYMBOL;
+    }
+}
+
+/* Returns past the closing quote of the string whose opening quote precedes c. */
+static const char* skip_string(const char *c)
+{
+    while (true)
+    {
+        c = raku_json_scan_string(c);
+        switch (*c)
+        {
+            case '"':
+                return c + 1;
+            case '\0':
+                return NULL;
+            case '\\':
+                if (c[1] == '\0')
+                    return NULL;
+                c += 2;
+                break;
+            default:
+                ++c;
+                break;
+        }
+    }
+}
+
+/*
+ * Finds the end of the value at c by matching quotes and brackets only.
+ * The contents of the skipped value are not validated.
+ */
+static enum raku_status skip_value(const char *c, const char **end)
+{
+    switch (*c)
+    {
+        case '"':
+            c = skip_string(c+1);
+            if (c == NULL)
+                return RAKU_JSON_UNTERMINATED_STRING;
+            break;
+        case '[':
+        case '{':
+        {
+            size_t depth = 0;
+            do
+            {
+                c = raku_json_scan_structure(c);
+                switch (*c)
+                {
+                    case '\0':
+                        return RAKU_JSON_UNEXPECTED_SYMBOL;
+                    case '"':
+                        c = skip_string(c+1);
+                        if (c == NULL)
+                            return RAKU_JSON_UNTERMINATED_STRING;
+                        continue;
+                    case '[':
+                    case '{':
+                        ++depth;
+                        break;
+                    default:
+                        --depth;
+                        break;
+                }
+                ++c;
+            } while (depth != 0);
+            break;
+        }
+        default:
+            while (*c != '\0' && *c != ',' && *c != ']' && *c != '}' && !is_whitespace(*c))
+                ++c;
+            break;
+    }
+
+    *end = c;
+    return RAKU_OK;
+}
+
+static enum raku_status read_number(const struct json_cursor *cursor, struct json_number *out)
+{
+    const char *c = cursor->value;
+    if (*c != '-' && (*c < '0' || *c > '9'))
+        return RAKU_OUT_OF_RANGE;
+
+    const char *end;
+    enum raku_status status = raku_json_number_read(c, &end, out);
+    out->_header.type = RAKU_JSON_NUMBER;
+    out->_header.flags = 0;
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_open(const char *src, struct json_cursor *out)
+{
+    ASSERT(src != NULL,
+           "raku_json_lazy_open: src must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_lazy_open: out must not be NULL!");
+
+    const char *c = skip_blanks(src);
+    enum raku_status status = check_value(c);
+    if (status == RAKU_OK)
+        out->value = c;
+
+    return status;
+}
+
+RAKU_API
+enum json_value_type raku_json_lazy_get_type(const struct json_cursor *cursor)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_get_type: cursor must not be NULL!");
+
+    switch (*cursor->value)
+    {
+        case 'f':
+        case 't':
+            return RAKU_JSON_BOOL;
+        case '"':
+            return RAKU_JSON_STRING;
+        case '[':
+            return RAKU_JSON_ARRAY;
+        case '{':
+            return RAKU_JSON_OBJECT;
+        case 'n':
+            return RAKU_JSON_NULL;
+        default:
+            return RAKU_JSON_NUMBER;
+    }
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_find_field(const struct json_cursor *object, const char *key, struct json_cursor *out)
+{
+    ASSERT(object != NULL,
+           "raku_json_lazy_find_field: object must not be NULL!");
+    ASSERT(key != NULL,
+           "raku_json_lazy_find_field: key must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_lazy_find_field: out must not be NULL!");
+
+    if (*object->value != '{')
+        return RAKU_OUT_OF_RANGE;
+
+    size_t size = strlen(key);
+    enum raku_status status = RAKU_OK;
+
+    const char *c = skip_blanks(object->value+1);
+    if (*c == '}')
+        return RAKU_OUT_OF_RANGE;
+
+    while (true)
+    {
+        if (*c != '"')
+            return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+        bool match;
+        const char *start = c+1;
+        const char *end = raku_json_scan_string(start);
+        if (*end == '"')
+        {
+            match = ((size_t)(end - start) == size) && (memcmp(start, key, size) == 0);
+            c = end+1;
+        }
+
+        else
+        {
+            struct json_parser parser;
+            struct raku_string decoded;
+            json_parser_init(&parser, start, RAKU_JSON_PARSE_DEFAULT, NULL);
+
+            status = json_parser_decode_string(&parser, &decoded);
+            match =
+                (status == RAKU_OK) &&
+                (decoded.count == size) &&
+                (memcmp(raku_string_chars(&decoded), key, size) == 0);
+            c = parser.lexer.current;
+
+            json_parser_free(&parser);
+            if (status != RAKU_OK)
+                return status;
+        }
+
+        c = skip_blanks(c);
+        if (*c != ':')
+            return RAKU_JSON_UNEXPECTED_SYMBOL;
+        c = skip_blanks(c+1);
+
+        status = check_value(c);
+        if (status != RAKU_OK)
+            return status;
+
+        if (match)
+        {
+            out->value = c;
+            return RAKU_OK;
+        }
+
+        status = skip_value(c, &c);
+        if (status != RAKU_OK)
+            return status;
+
+        c = skip_blanks(c);
+        if (*c == '}')
+            return RAKU_OUT_OF_RANGE;
+        else if (*c != ',')
+            return RAKU_JSON_UNEXPECTED_SYMBOL;
+        c = skip_blanks(c+1);
+    }
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_first(const struct json_cursor *array, struct json_cursor *out)
+{
+    ASSERT(array != NULL,
+           "raku_json_lazy_first: array must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_lazy_first: out must not be NULL!");
+
+    if (*array->value != '[')
+        return RAKU_OUT_OF_RANGE;
+
+    const char *c = skip_blanks(array->value+1);
+    if (*c == ']')
+        return RAKU_OUT_OF_RANGE;
+
+    enum raku_status status = check_value(c);
+    if (status == RAKU_OK)
+        out->value = c;
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_next(struct json_cursor *element)
+{
+    ASSERT(element != NULL,
+           "raku_json_lazy_next: element must not be NULL!");
+
+    const char *c;
+    enum raku_status status = skip_value(element->value, &c);
+    if (status != RAKU_OK)
+        return status;
+
+    c = skip_blanks(c);
+    if (*c == ']')
+        return RAKU_OUT_OF_RANGE;
+    else if (*c != ',')
+        return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+    c = skip_blanks(c+1);
+    status = check_value(c);
+    if (status == RAKU_OK)
+        element->value = c;
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_at(const struct json_cursor *array, unsigned int index, struct json_cursor *out)
+{
+    ASSERT(array != NULL,
+           "raku_json_lazy_at: array must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_lazy_at: out must not be NULL!");
+
+    struct json_cursor element;
+    enum raku_status status = raku_json_lazy_first(array, &element);
+    for (unsigned int i = 0; i < index && status == RAKU_OK; ++i)
+        status = raku_json_lazy_next(&element);
+
+    if (status == RAKU_OK)
+        *out = element;
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_get_bool(const struct json_cursor *cursor, bool *out)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_get_bool: cursor must not be NULL!");
+
+    if (strncmp(cursor->value, "true", 4) == 0)
+        *out = true;
+    else if (strncmp(cursor->value, "false", 5) == 0)
+        *out = false;
+    else
+        return RAKU_OUT_OF_RANGE;
+
+    return RAKU_OK;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_get_number(const struct json_cursor *cursor, double *out)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_get_number: cursor must not be NULL!");
+
+    struct json_number number;
+    enum raku_status status = read_number(cursor, &number);
+    if (status == RAKU_OK)
+        *out = raku_json_number_get(&number);
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_get_int64(const struct json_cursor *cursor, int64_t *out)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_get_int64: cursor must not be NULL!");
+
+    struct json_number number;
+    enum raku_status status = read_number(cursor, &number);
+    if (status == RAKU_OK)
+        status = raku_json_number_get_int64(&number, out);
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_get_uint64(const struct json_cursor *cursor, uint64_t *out)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_get_uint64: cursor must not be NULL!");
+
+    struct json_number number;
+    enum raku_status status = read_number(cursor, &number);
+    if (status == RAKU_OK)
+        status = raku_json_number_get_uint64(&number, out);
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_get_string(const struct json_cursor *cursor, struct raku_string *out)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_get_string: cursor must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_lazy_get_string: out must not be NULL!");
+
+    if (*cursor->value != '"')
+        return RAKU_OUT_OF_RANGE;
+
+    /* Decode straight into out's storage: the parser only uses it as scratch. */
+    struct json_parser parser;
+    json_parser_init(&parser, cursor->value+1, RAKU_JSON_PARSE_DEFAULT, NULL);
+    raku_string_own(&parser.buffer, out);
+
+    struct raku_string decoded;
+    enum raku_status status = json_parser_decode_string(&parser, &decoded);
+    if (status == RAKU_OK && raku_string_chars(&decoded) == cursor->value+1)
+    {
+        parser.buffer.count = 0;
+        if (decoded.count != 0)
+            status = raku_string_writes(&parser.buffer, &decoded);
+        else if (raku_string_chars(&parser.buffer) != NULL)
+            raku_string_chars(&parser.buffer)[0] = '\0';
+    }
+
+    raku_string_own(out, &parser.buffer);
+    return status;
+}
+
+RAKU_API
+bool raku_json_lazy_equalc(const struct json_cursor *cursor, const char *value)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_equalc: cursor must not be NULL!");
+    ASSERT(value != NULL,
+           "raku_json_lazy_equalc: value must not be NULL!");
+
+    if (*cursor->value != '"')
+        return false;
+
+    struct json_parser parser;
+    json_parser_init(&parser, cursor->value+1, RAKU_JSON_PARSE_DEFAULT, NULL);
+
+    struct raku_string decoded;
+    bool equal =
+        (json_parser_decode_string(&parser, &decoded) == RAKU_OK) &&
+        (decoded.count == strlen(value)) &&
+        (memcmp(raku_string_chars(&decoded), value, decoded.count) == 0);
+
+    json_parser_free(&parser);
+    return equal;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_get_snowflake(const struct json_cursor *cursor, raku_snowflake *out)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_get_snowflake: cursor must not be NULL!");
+
+    if (*cursor->value == '"')
+    {
+        const char *start = cursor->value+1;
+        const char *end = raku_json_scan_string(start);
+        if (*end != '"')
+            return RAKU_JSON_INVALID_SNOWFLAKE;
+
+        return raku_snowflake_parse(start, (unsigned int)(end - start), out);
+    }
+
+    struct json_number number;
+    if (read_number(cursor, &number) == RAKU_OK &&
+        raku_json_number_get_uint64(&number, out) == RAKU_OK)
+    {
+        return RAKU_OK;
+    }
+
+    return RAKU_JSON_INVALID_SNOWFLAKE;
+}
+
+RAKU_API
+enum raku_status raku_json_lazy_parse(const struct json_cursor *cursor, struct raku_arena *arena, struct json_value **out)
+{
+    ASSERT(cursor != NULL,
+           "raku_json_lazy_parse: cursor must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_lazy_parse: out must not be NULL!");
+
+    struct json_parser parser;
+    json_parser_init(&parser, cursor->value, RAKU_JSON_PARSE_DEFAULT, arena);
+
+    enum raku_status status = json_parser_read_value(&parser, out);
+
+    json_parser_free(&parser);
+    return status;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef RAKU_JSON_NUMBER_H
+#define RAKU_JSON_NUMBER_H
+
+#include "json_values.h"
+
+#define RAKU_JSON_NUMBER_MAX_CHARS 32
+
+/*
+ * Reads the JSON number starting at src into number. Integer literals that
+ * fit in 64 bits are stored exactly, everything else is converted to the
+ * nearest double. *end is set past the number, or to the offending byte on
+ * error.
+ */
+RAKU_LOCAL
+enum raku_status raku_json_number_read(const char *src, const char **end, struct json_number *number);
+
+/*
+ * Formats number into buffer, which must hold RAKU_JSON_NUMBER_MAX_CHARS
+ * bytes, and returns the count of chars written (no NUL terminator).
+ * Doubles are written with the shortest (in all but rare cases) digits that
+ * read back to the same value, non-finite values as null.
+ */
+RAKU_LOCAL
+unsigned int raku_json_number_format(const struct json_number *number, char *buffer);
+
+/* Returns the count of chars raku_json_number_format() writes for number. */
+RAKU_LOCAL
+unsigned int raku_json_number_size(const struct json_number *number);
+
+#endif
\ No newline at end of file
@@ -1,79 +1,147 @@
 #include <RAKU/json.h>
-#include "json_values.h"
+#include "json_parse.h"
+#include "json_atoms.h"
+#include "json_number.h"
+#include <RAKU/core/memory.h>
 #include <RAKU/debug.h>
 
-#include <ctype.h>
+#include <limits.h>
 #include <string.h>
-#include <math.h>
 
 #define STACK_CAPACITY 64
 
 #define ERROR(c, r) ((struct json_error) { .column = (c), .row = (r) })
 
-struct json_parser
-{
-    struct lexer
-    {
-        const char *start;
-        const char *current;
-        unsigned int column;
-        unsigned int row;
-    } lexer;
-};
-
-void json_parser_init(struct json_parser *parser, const char *src)
+RAKU_LOCAL
+void json_parser_init(
+    struct json_parser *parser,
+    const char *src,
+    enum json_parse_option options,
+    struct raku_arena *arena)
 {
     parser->lexer.start = src;
     parser->lexer.current = src;
     parser->lexer.column = 1;
     parser->lexer.row = 1;
-}
 
-static inline bool at_end(struct lexer *lexer)
-{
-    return *lexer->current == '\0';
-}
+    parser->options = options;
+    parser->arena = arena;
+    raku_string_init(&parser->buffer);
 
-static inline char advance(struct lexer *lexer)
-{
-    return ++lexer->column, *(lexer->current++);
+    parser->stack.values = NULL;
+    parser->stack.count = 0;
+    parser->stack.capacity = 0;
 }
 
-static inline char peek(struct lexer *lexer)
+RAKU_LOCAL
+void json_parser_free(struct json_parser *parser)
 {
-    return *lexer->current;
+    raku_string_free(&parser->buffer);
+    raku_free(parser->stack.values, parser->stack.capacity * sizeof(struct json_value*));
 }
 
-static inline char peek_next(struct lexer *lexer)
+static enum raku_status alloc_storage(struct json_parser *parser, enum raku_memory_category category, size_t size, void **out)
 {
-    return lexer->current[1];
+    if (parser->arena != NULL)
+        return raku_arena_alloc(parser->arena, size, out);
+    else
+        return raku_alloc_for(category, size, out);
 }
 
-static inline bool is_hex(const char c)
+RAKU_LOCAL
+enum raku_status json_parser_create_value(struct json_parser *parser, enum json_value_type type, struct json_value **out)
 {
-    return
-        (c >= '0' && c <= '9') ||
-        (c >= 'a' && c <= 'f') ||
-        (c >= 'A' && c <= 'F');
+    size_t size = raku_json_node_size(type);
+    if (size == 0)
+    {
+        ASSERT(false, "json_parser_create_value: invalid json value type.");
+        return RAKU_OUT_OF_RANGE;
+    }
+
+    struct json_value *value;
+    enum raku_status status =
+        (parser->arena != NULL) ?
+            raku_arena_alloc(parser->arena, size, (void**)&value) :
+            raku_pool_alloc(size, (void**)&value);
+    if (status != RAKU_OK)
+        return status;
+
+    switch (type)
+    {
+        case RAKU_JSON_BOOL:
+            raku_json_bool_init((struct json_bool*)value);
+            break;
+        case RAKU_JSON_NUMBER:
+            raku_json_number_init((struct json_number*)value);
+            break;
+        case RAKU_JSON_STRING:
+            raku_json_string_init((struct json_string*)value);
+            break;
+        case RAKU_JSON_ARRAY:
+            raku_json_array_init((struct json_array*)value);
+            break;
+        default:
+            raku_json_object_init((struct json_object*)value);
+            break;
+    }
+
+    if (parser->arena != NULL)
+        value->flags |= RAKU_JSON_FLAG_ARENA;
+
+    *out = value;
+    return RAKU_OK;
 }
 
-static inline bool is_char(const char c)
+RAKU_LOCAL
+enum raku_status json_parser_push_value(struct json_parser *parser, struct json_value *value)
 {
-    return
-        (c < 0) ||
-        (c == 0x20) ||
-        (c == 0x21) ||
-        (c > 0x22);
+    struct value_stack *stack = &parser->stack;
+    if (stack->count == stack->capacity)
+    {
+        if (stack->capacity > (UINT_MAX / 2))
+            return RAKU_NO_MEMORY;
+
+        unsigned int new_capacity =
+            (stack->capacity < STACK_CAPACITY) ?
+                STACK_CAPACITY :
+                2 * stack->capacity;
+
+        enum raku_status status = raku_realloc(
+            stack->values,
+            stack->capacity * sizeof(struct json_value*),
+            new_capacity * sizeof(struct json_value*),
+            (void**)&stack->values
+        );
+
+        if (status != RAKU_OK)
+            return status;
+
+        stack->capacity = new_capacity;
+    }
+
+    stack->values[stack->count++] = value;
+    return RAKU_OK;
 }
 
-static inline bool is_word(const char *start, unsigned int count, const char *comp)
+RAKU_LOCAL
+void json_parser_pop_values(struct json_parser *parser, unsigned int base, bool release)
 {
-    return (strncmp(start, comp, count) == 0);
+    if (release)
+    {
+        for (unsigned int i = base; i < parser->stack.count; ++i)
+        {
+            raku_json_value_free(parser->stack.values[i]);
+        }
+    }
+    parser->stack.count = base;
 }
 
-static inline int get_digit_value(const char c)
+static inline bool is_hex(const char c)
 {
-    return c - '0';
+    return
+        (c >= '0' && c <= '9') ||
+        (c >= 'a' && c <= 'f') ||
+        (c >= 'A' && c <= 'F');
 }
 
 static unsigned char get_hex_value(const char c)
@@ -86,28 +154,6 @@ static unsigned char get_hex_value(const char c)
             (c - 'a') + 10;
 }
 
-static void skip_whitespaces(struct lexer *lexer)
-{
-    while (true)
-    {
-        switch (*lexer->current)
-        {
-            case 0x0A:
-                ++lexer->row;
-                lexer->column = 0;
-            case 0x09:
-            case 0x0D:
-            case 0x20:
-                advance(lexer);
-                continue;
-        }
-
-        break;
-    }
-
-    lexer->start = lexer->current;
-}
-
 static enum raku_status get_utf16(struct lexer *lexer, uint16_t *out)
 {
     enum raku_status status = RAKU_OK;
@@ -132,138 +178,173 @@ gu16_end:
 
 static enum raku_status parse_value(struct json_parser *parser, struct json_value **out);
 
-static enum raku_status parse_string(struct json_parser *parser, struct json_value **out)
+static enum raku_status write_code_point(struct raku_string *string, uint32_t unicode)
 {
-    struct raku_string string;
-    raku_string_init(&string);
+    char bytes[4];
+    unsigned int count;
+
+    if (unicode > 0x10FFFF)
+        return RAKU_JSON_INVALID_CODE_POINT;
 
+    else if (unicode > 0xFFFF)
+    {
+        bytes[0] = (char)((unicode >> 18) + 0xF0);
+        bytes[1] = (char)(((unicode >> 12) & 0x3F) + 0x80);
+        bytes[2] = (char)(((unicode >> 6) & 0x3F) + 0x80);
+        bytes[3] = (char)((unicode & 0x3F) + 0x80);
+        count = 4;
+    }
+
+    else if (unicode > 0x07FF)
+    {
+        bytes[0] = (char)((unicode >> 12) + 0xE0);
+        bytes[1] = (char)(((unicode >> 6) & 0x3F) + 0x80);
+        bytes[2] = (char)((unicode & 0x3F) + 0x80);
+        count = 3;
+    }
+
+    else if (unicode > 0x7F)
+    {
+        bytes[0] = (char)((unicode >> 6) + 0xC0);
+        bytes[1] = (char)((unicode & 0x3F) + 0x80);
+        count = 2;
+    }
+
+    else
+    {
+        bytes[0] = (char)unicode;
+        count = 1;
+    }
+
+    return raku_string_append_n(string, bytes, count);
+}
+
+static enum raku_status parse_escape(struct lexer *lexer, struct raku_string *string)
+{
     enum raku_status status = RAKU_OK;
-    while (is_char(peek(&parser->lexer)))
+
+    char c = advance(lexer);
+    switch (c)
     {
-        char c = advance(&parser->lexer);
-        if (c == '\\')
+        case '"':
+        case '/':
+        case '\\':
+            status = raku_string_write(string, c);
+            break;
+        case 'b':
+            status = raku_string_write(string, '\b');
+            break;
+        case 'f':
+            status = raku_string_write(string, '\f');
+            break;
+        case 'n':
+            status = raku_string_write(string, '\n');
+            break;
+        case 'r':
+            status = raku_string_write(string, '\r');
+            break;
+        case 't':
+            status = raku_string_write(string, '\t');
+            break;
+        case 'u':
         {
-            c = advance(&parser->lexer);
-            switch (c)
+            uint16_t lead;
+            status = get_utf16(lexer, &lead);
+            if (status != RAKU_OK)
+                break;
+
+            /* Surrogates only ever come as a high one followed by a low one. */
+            uint32_t unicode = lead;
+            if ((lead & 0xFC00) == 0xDC00)
             {
-                case '"':
-                case '/':
-                case '\\':
-                    status = raku_string_write(&string, c);
-                    break;
-                case 'b':
-                    status = raku_string_write(&string, '\b');
-                    break;
-                case 'f':
-                    status = raku_string_write(&string, '\f');
-                    break;
-                case 'n':
-                    status = raku_string_write(&string, '\n');
-                    break;
-                case 'r':
-                    status = raku_string_write(&string, '\r');
+                status = RAKU_JSON_INVALID_SURROGATE_PAIR;
+                break;
+            }
+
+            if ((lead & 0xFC00) == 0xD800)
+            {
+                /* Stop on the offending byte, a stream may still be missing it. */
+                bool escape = (peek(lexer) == '\\');
+                if (escape)
+                    advance(lexer);
+                if (!escape || peek(lexer) != 'u')
+                {
+                    status = RAKU_JSON_INVALID_SURROGATE_PAIR;
                     break;
-                case 't':
-                    status = raku_string_write(&string, '\t');
+                }
+
+                advance(lexer);
+
+                uint16_t trail;
+                status = get_utf16(lexer, &trail);
+                if (status != RAKU_OK)
                     break;
-                case 'x':
-                {
-                    uint32_t unicode;
-                    status = get_utf16(&parser->lexer, (uint16_t*)&unicode+1);
-                    if (status != RAKU_OK)
-                        goto ps_end;
-                    
-                    if ((unicode & 0xFC00) == 0xD800 &&
-                        peek(&parser->lexer) == '\\' &&
-                        peek_next(&parser->lexer) == 'x')
-                    {
-                        advance(&parser->lexer); advance(&parser->lexer);
-
-                        uint16_t trail;
-                        status = get_utf16(&parser->lexer, &trail);
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                        
-                        if ((trail & 0xFC00) != 0xDC00)
-                        {
-                            status = RAKU_JSON_INVALID_SURROGATE_PAIR;
-                            goto ps_end;
-                        }
-
-                        unicode = ((unicode - 0xD800) << 10) | (trail - 0xDC00) + 0x10000;
-                    }
-
-                    if (unicode > 0x10FFFF)
-                    {
-                        status = RAKU_JSON_INVALID_CODE_POINT;
-                        goto ps_end;
-                    }
-
-                    else if (unicode > 0xFFFF)
-                    {
-                        status = raku_string_write(&string, (char)((unicode >> 18) + 0xF0));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                        
-                        status = raku_string_write(&string, (char)(((unicode >> 12) & 0x3F) + 0x80));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                        
-                        status = raku_string_write(&string, (char)(((unicode >> 6) & 0x3F) + 0x80));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                        
-                        status = raku_string_write(&string, (char)((unicode & 0x3F) + 0x80));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                    }
-
-                    else if (unicode > 0x07FF)
-                    {
-                        status = raku_string_write(&string, (char)((unicode >> 12) + 0xE0));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                        
-                        status = raku_string_write(&string, (char)(((unicode >> 6) & 0x3F) + 0x80));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                        
-                        status = raku_string_write(&string, (char)((unicode & 0x3F) + 0x80));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                    }
-
-                    else if (unicode > 0x7F)
-                    {
-                        status = raku_string_write(&string, (char)((unicode >> 6) + 0xC0));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                        
-                        status = raku_string_write(&string, (char)((unicode & 0x3F) + 0x80));
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                    }
-
-                    else
-                    {
-                        status = raku_string_write(&string, (char)unicode);
-                        if (status != RAKU_OK)
-                            goto ps_end;
-                    }
 
+                if ((trail & 0xFC00) != 0xDC00)
+                {
+                    status = RAKU_JSON_INVALID_SURROGATE_PAIR;
                     break;
                 }
-                default:
-                    status = RAKU_JSON_INVALID_ESCAPE_SEQUENCE;
-                    break;
+
+                unicode = (((unicode - 0xD800) << 10) | (trail - 0xDC00)) + 0x10000;
             }
+
+            status = write_code_point(string, unicode);
+            break;
         }
+        default:
+            status = RAKU_JSON_INVALID_ESCAPE_SEQUENCE;
+            break;
+    }
 
-        else
-            status = raku_string_write(&string, c);
+    return status;
+}
+
+RAKU_LOCAL
+enum raku_status json_parser_decode_string(struct json_parser *parser, struct raku_string *out)
+{
+    const char *end = raku_json_scan_string(parser->lexer.current);
+    if (*end == '"')
+    {
+        const char *start = parser->lexer.current;
+        out->data.heap.chars = (char*)start;
+        out->data.heap.capacity = (unsigned int)(end - start);
+        out->count = out->data.heap.capacity;
+        out->is_inline = false;
+
+        parser->lexer.column += out->count + 1;
+        parser->lexer.current = end + 1;
+        return RAKU_OK;
+    }
+
+    struct raku_string *string = &parser->buffer;
+    string->count = 0;
 
+    enum raku_status status = RAKU_OK;
+    while (true)
+    {
+        const char *run = parser->lexer.current;
+        if (end == NULL)
+            end = raku_json_scan_string(run);
+        if (end != run)
+        {
+            status = raku_string_append_n(string, run, (unsigned int)(end - run));
+            if (status != RAKU_OK)
+                goto pds_end;
+
+            parser->lexer.column += (unsigned int)(end - run);
+            parser->lexer.current = end;
+        }
+
+        if (peek(&parser->lexer) != '\\')
+            break;
+
+        advance(&parser->lexer);
+        status = parse_escape(&parser->lexer, string);
         if (status != RAKU_OK)
-            goto ps_end;
+            goto pds_end;
+
+        end = NULL;
     }
 
     if (peek(&parser->lexer) == '"')
@@ -271,133 +352,201 @@ static enum raku_status parse_string(struct json_parser *parser, struct json_val
     else
     {
         status = RAKU_JSON_UNTERMINATED_STRING;
+        goto pds_end;
     }
 
-ps_end:
+    *out = *string;
+
+pds_end:
+    return status;
+}
+
+RAKU_LOCAL
+enum raku_status json_parser_read_string(struct json_parser *parser, struct json_value **out)
+{
+    const char *start = parser->lexer.current;
+
+    struct raku_string decoded;
+    enum raku_status status = json_parser_decode_string(parser, &decoded);
     if (status != RAKU_OK)
-        raku_string_free(&string);
+        goto ps_end;
+
+    struct json_string *value;
+    status = json_parser_create_value(parser, RAKU_JSON_STRING, (struct json_value**)&value);
+    if (status != RAKU_OK)
+        goto ps_end;
+
+    if ((parser->options & RAKU_JSON_PARSE_VIEWS) && raku_string_chars(&decoded) == start)
+    {
+        raku_json_string_attach(value, &decoded);
+        value->_header.flags |= RAKU_JSON_FLAG_VIEW;
+        *out = (struct json_value*)value;
+        goto ps_end;
+    }
+
+    struct raku_string copy = {
+        .data.heap = { .chars = NULL, .capacity = decoded.count },
+        .count = decoded.count,
+        .is_inline = false
+    };
+
+    /* Short strings, such as most names, are stored inline in the node. */
+    if (copy.count < RAKU_STRING_INLINE_SIZE)
+        copy.is_inline = true;
     else
     {
-        struct json_string *value;
-        status = raku_json_string_create(&value);
-        if (status == RAKU_OK)
+        status = alloc_storage(parser, RAKU_MEMORY_STRINGS, copy.count+1, (void**)&copy.data.heap.chars);
+        if (status != RAKU_OK)
         {
-            raku_json_string_set(value, &string);
-            *out = (struct json_value*)value;
+            raku_json_value_free((struct json_value*)value);
+            goto ps_end;
         }
     }
 
+    char *chars = raku_string_chars(&copy);
+    if (copy.count > 0)
+        memcpy(chars, raku_string_chars(&decoded), copy.count);
+    chars[copy.count] = '\0';
+
+    raku_json_string_attach(value, &copy);
+    *out = (struct json_value*)value;
+
+ps_end:
     return status;
 }
 
+RAKU_LOCAL
+enum raku_status json_parser_read_key(struct json_parser *parser, struct json_value **out)
+{
+    struct raku_string decoded;
+    enum raku_status status = json_parser_decode_string(parser, &decoded);
+    if (status != RAKU_OK)
+        return status;
+
+    return raku_json_atom_acquire(
+        raku_string_chars(&decoded),
+        decoded.count,
+        raku_json_hash(raku_string_chars(&decoded), decoded.count),
+        parser->arena,
+        (struct json_atom**)out
+    );
+}
+
 static enum raku_status parse_number(struct json_parser *parser, struct json_value **out)
 {
-    enum raku_status status = RAKU_OK;
-    parser->lexer.current = parser->lexer.start;
-    --parser->lexer.column;
+    const char *end;
+    struct json_number read;
+    enum raku_status status = raku_json_number_read(parser->lexer.start, &end, &read);
 
-    double sign = 1;
-    if (peek(&parser->lexer) == '-')
-    {
-        advance(&parser->lexer);
-        if (!isdigit(peek(&parser->lexer)))
-        {
-            status = RAKU_JSON_INVALID_NUMBER;
-            goto pn_end;
-        }
+    parser->lexer.column += (unsigned int)(end - parser->lexer.current);
+    parser->lexer.current = end;
+    if (status != RAKU_OK)
+        goto pn_end;
 
-        sign = -1;
-    }
-    
-    double value = 0;
-    while (isdigit(peek(&parser->lexer)))
+    struct json_number *number;
+    status = json_parser_create_value(parser, RAKU_JSON_NUMBER, (struct json_value**)&number);
+    if (status == RAKU_OK)
     {
-        value = (value * 10) + get_digit_value(advance(&parser->lexer));
+        number->kind = read.kind;
+        number->value = read.value;
+        *out = (struct json_value*)number;
     }
-    
-    if (peek(&parser->lexer) == '.')
-    {
-        int count = 0;
-        double precision = 0;
 
-        advance(&parser->lexer);
-        if (!isdigit(peek(&parser->lexer)))
-        {
-            status = RAKU_JSON_MISSING_PRECISION;
-            goto pn_end;
-        }
+pn_end:
+    return status;
+}
 
-        while (isdigit(peek(&parser->lexer)))
-        {
-            precision = (precision * 10) + get_digit_value(advance(&parser->lexer));
-            --count;
-        }
+RAKU_LOCAL
+enum raku_status json_parser_finish_array(struct json_parser *parser, unsigned int base, struct json_value **out)
+{
+    struct json_array *array;
+    enum raku_status status = json_parser_create_value(parser, RAKU_JSON_ARRAY, (struct json_value**)&array);
+    if (status != RAKU_OK)
+        goto fa_end;
 
-        for (; count < 0; ++count)
+    unsigned int count = parser->stack.count - base;
+    bool packed = false;
+    if (count > 0 && (parser->options & RAKU_JSON_PARSE_TYPED_ARRAYS) && parser->arena == NULL)
+    {
+        /* Packing frees the values, which the caller then only drops from the stack. */
+        status = raku_json_array_pack(array, parser->stack.values+base, count);
+        packed = (status == RAKU_OK);
+        if (status == RAKU_OUT_OF_RANGE)
+            status = RAKU_OK;
+        else if (status != RAKU_OK)
         {
-            precision /= 10;
+            raku_json_value_free((struct json_value*)array);
+            goto fa_end;
         }
-
-        value += precision;
     }
 
-    if (peek(&parser->lexer) == 'E' ||
-        peek(&parser->lexer) == 'e')
+    if (count > 0 && !packed)
     {
-        double exp = 0;
-        double sign = 1;
+        status = alloc_storage(
+            parser,
+            RAKU_MEMORY_ARRAYS,
+            count * sizeof(struct json_value*),
+            (void**)&array->values
+        );
 
-        advance(&parser->lexer);
-        if (peek(&parser->lexer) == '-')
+        if (status != RAKU_OK)
         {
-            sign = -1;
-            advance(&parser->lexer);
+            raku_json_value_free((struct json_value*)array);
+            goto fa_end;
         }
 
-        else if (peek(&parser->lexer) == '+')
-            advance(&parser->lexer);
-        
-        if (!isdigit(peek(&parser->lexer)))
-        {
-            status = RAKU_JSON_MISSING_EXPONENT;
-            goto pn_end;
-        }
+        memcpy(array->values, parser->stack.values+base, count * sizeof(struct json_value*));
+        array->count = count;
+        array->capacity = count;
+    }
 
-        while (isdigit(peek(&parser->lexer)))
-        {
-            exp = (exp * 10) + get_digit_value(advance(&parser->lexer));
-        }
+    *out = (struct json_value*)array;
 
-        double factor = 1;
-        for (; exp > 0; --exp)
-        {
-            factor *= 10;
-        }
+fa_end:
+    return status;
+}
 
-        if (sign == -1)
-            value /= factor;
-        else
-            value *= factor;
-    }
+RAKU_LOCAL
+enum raku_status json_parser_finish_object(struct json_parser *parser, unsigned int base, struct json_value **out)
+{
+    struct json_object *object;
+    enum raku_status status = json_parser_create_value(parser, RAKU_JSON_OBJECT, (struct json_value**)&object);
+    if (status != RAKU_OK)
+        goto fo_end1;
 
-    struct json_number *number;
-    status = raku_json_number_create(&number);
-    if (status == RAKU_OK)
+    unsigned int count = (parser->stack.count - base) / 2;
+    if (count > 0)
     {
-        raku_json_number_set(number, sign * value);
-        *out = (struct json_value*)number;
+        unsigned int buckets = raku_json_object_buckets_for(count);
+
+        void *storage;
+        status = alloc_storage(parser, RAKU_MEMORY_OBJECT_TABLES, raku_json_object_storage_size(count, buckets), &storage);
+        if (status != RAKU_OK)
+            goto fo_end2;
+
+        raku_json_object_attach(object, storage, count, buckets);
+
+        struct json_value **pairs = parser->stack.values+base;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            raku_json_object_insert(object, (struct json_atom*)pairs[2*i], pairs[2*i+1]);
+        }
     }
 
-pn_end:
+fo_end2:
+    if (status != RAKU_OK)
+        raku_json_value_free((struct json_value*)object);
+    else
+        *out = (struct json_value*)object;
+
+fo_end1:
     return status;
 }
 
 static enum raku_status parse_array(struct json_parser *parser, struct json_value **out)
 {
-    struct json_array *array = NULL;
-    enum raku_status status = raku_json_array_create(&array);
-    if (status != RAKU_OK)
-        goto pa_end1;
+    unsigned int base = parser->stack.count;
+    enum raku_status status = RAKU_OK;
 
     skip_whitespaces(&parser->lexer);
     if (peek(&parser->lexer) != ']')
@@ -409,13 +558,13 @@ static enum raku_status parse_array(struct json_parser *parser, struct json_valu
             struct json_value *value;
             status = parse_value(parser, &value);
             if (status != RAKU_OK)
-                goto pa_end2;
+                goto pa_end;
 
-            status = raku_json_array_push(array, value);
+            status = json_parser_push_value(parser, value);
             if (status != RAKU_OK)
             {
                 raku_json_value_free(value);
-                goto pa_end2;
+                goto pa_end;
             }
 
             skip_whitespaces(&parser->lexer);
@@ -423,27 +572,24 @@ static enum raku_status parse_array(struct json_parser *parser, struct json_valu
     }
 
     if (peek(&parser->lexer) != ']')
+    {
         status = RAKU_JSON_UNEXPECTED_SYMBOL;
-    else
-        advance(&parser->lexer);
+        goto pa_end;
+    }
+    advance(&parser->lexer);
 
-pa_end2:
-    if (status != RAKU_OK)
-        raku_json_value_free((struct json_value*)array);
-    else
-        *out = (struct json_value*)array;
+    status = json_parser_finish_array(parser, base, out);
 
-pa_end1:
+pa_end:
+    json_parser_pop_values(parser, base, status != RAKU_OK);
     return status;
 }
 
 static enum raku_status parse_object(struct json_parser *parser, struct json_value **out)
 {
-    struct json_object *object = NULL;
-    enum raku_status status = raku_json_object_create(&object);
-    if (status != RAKU_OK)
-        goto po_end1;
-    
+    unsigned int base = parser->stack.count;
+    enum raku_status status = RAKU_OK;
+
     skip_whitespaces(&parser->lexer);
     if (peek(&parser->lexer) != '}')
     {
@@ -453,40 +599,42 @@ static enum raku_status parse_object(struct json_parser *parser, struct json_val
             if (peek(&parser->lexer) != '"')
             {
                 status = RAKU_JSON_UNEXPECTED_SYMBOL;
-                goto po_end2;
+                goto po_end;
             }
             advance(&parser->lexer);
 
-            struct json_string *key;
-            status = parse_string(parser, (struct json_value**)&key);
+            struct json_value *key;
+            status = json_parser_read_key(parser, &key);
             if (status != RAKU_OK)
-                goto po_end2;
-            
+                goto po_end;
+
+            status = json_parser_push_value(parser, key);
+            if (status != RAKU_OK)
+            {
+                raku_json_value_free(key);
+                goto po_end;
+            }
+
             skip_whitespaces(&parser->lexer);
             if (peek(&parser->lexer) != ':')
             {
                 status = RAKU_JSON_UNEXPECTED_SYMBOL;
-                raku_json_value_free((struct json_value*)key);
-                goto po_end2;
+                goto po_end;
             }
             advance(&parser->lexer);
-            
+
             skip_whitespaces(&parser->lexer);
 
             struct json_value *value;
             status = parse_value(parser, &value);
             if (status != RAKU_OK)
-            {
-                raku_json_value_free((struct json_value*)key);
-                goto po_end2;
-            }
+                goto po_end;
 
-            status = raku_json_object_set(object, key->value.chars, value);
-            raku_json_value_free((struct json_value*)key);
+            status = json_parser_push_value(parser, value);
             if (status != RAKU_OK)
             {
                 raku_json_value_free(value);
-                goto po_end2;
+                goto po_end;
             }
 
             skip_whitespaces(&parser->lexer);
@@ -494,17 +642,16 @@ static enum raku_status parse_object(struct json_parser *parser, struct json_val
     }
 
     if (peek(&parser->lexer) != '}')
+    {
         status = RAKU_JSON_UNEXPECTED_SYMBOL;
-    else
-        advance(&parser->lexer);
-    
-po_end2:
-    if (status != RAKU_OK)
-        raku_json_value_free((struct json_value*)object);
-    else
-        *out = (struct json_value*)object;
-    
-po_end1:
+        goto po_end;
+    }
+    advance(&parser->lexer);
+
+    status = json_parser_finish_object(parser, base, out);
+
+po_end:
+    json_parser_pop_values(parser, base, status != RAKU_OK);
     return status;
 }
 
@@ -524,7 +671,7 @@ static enum raku_status parse_value(struct json_parser *parser, struct json_valu
             else
             {
                 parser->lexer.current += 3;
-                value = NULL;
+                value = raku_json_null();
             }
             break;
         case 'f':
@@ -533,11 +680,7 @@ static enum raku_status parse_value(struct json_parser *parser, struct json_valu
             else
             {
                 parser->lexer.current += 4;
-                status = raku_json_bool_create((struct json_bool**)&value);
-                if (status != RAKU_OK)
-                    goto pv_end;
-                
-                raku_json_bool_set((struct json_bool*)value, false);
+                value = (struct json_value*)raku_json_false();
             }
             break;
         case 't':
@@ -546,22 +689,13 @@ static enum raku_status parse_value(struct json_parser *parser, struct json_valu
             else
             {
                 parser->lexer.current += 3;
-                status = raku_json_bool_create((struct json_bool**)&value);
-                if (status != RAKU_OK)
-                    goto pv_end;
-                
-                raku_json_bool_set((struct json_bool*)value, true);
+                value = (struct json_value*)raku_json_true();
             }
             break;
         case '"':
-            status = parse_string(parser, &value);
+            status = json_parser_read_string(parser, &value);
             break;
         case '0':
-            if (isdigit(peek(&parser->lexer)))
-            {
-                status = RAKU_JSON_INVALID_NUMBER;
-                goto pv_end;
-            }
         case '1':
         case '2':
         case '3':
@@ -585,7 +719,6 @@ static enum raku_status parse_value(struct json_parser *parser, struct json_valu
             break;
     }
 
-pv_end:
     if (status == RAKU_OK)
         *out = value;
     else
@@ -594,6 +727,44 @@ pv_end:
     return status;
 }
 
+RAKU_LOCAL
+enum raku_status json_parser_read_value(struct json_parser *parser, struct json_value **out)
+{
+    return parse_value(parser, out);
+}
+
+static enum raku_status parse_document(
+    const char *src,
+    enum json_parse_option options,
+    struct raku_arena *arena,
+    struct json_value **out,
+    struct json_error *err)
+{
+    struct json_parser parser;
+    json_parser_init(&parser, src, options, arena);
+
+    struct json_value *value;
+    enum raku_status status = parse_value(&parser, &value);
+    if (status == RAKU_OK)
+    {
+        skip_whitespaces(&parser.lexer);
+        if (!at_end(&parser.lexer))
+        {
+            status = RAKU_JSON_EXPECTED_END;
+            raku_json_value_free(value);
+        }
+
+        else
+            *out = value;
+    }
+
+    if (status != RAKU_OK)
+        *err = ERROR(parser.lexer.column, parser.lexer.row);
+
+    json_parser_free(&parser);
+    return status;
+}
+
 RAKU_API
 enum raku_status raku_json_parse(const char *src, struct json_value **out)
 {
@@ -616,26 +787,56 @@ enum raku_status raku_json_parse_err(const char *src, struct json_value **out, s
     ASSERT(err != NULL,
            "raku_json_parse_err: err must not be NULL!");
 
-    struct json_parser parser;
-    json_parser_init(&parser, src);
+    return parse_document(src, RAKU_JSON_PARSE_DEFAULT, NULL, out, err);
+}
 
-    struct json_value *value;
-    enum raku_status status = parse_value(&parser, &value);
-    if (status == RAKU_OK)
-    {
-        skip_whitespaces(&parser.lexer);
-        if (!at_end(&parser.lexer))
-        {
-            status = RAKU_JSON_EXPECTED_END;
-            raku_json_value_free(value);
-        }
+RAKU_API
+enum raku_status raku_json_parse_arena(const char *src, struct raku_arena *arena, struct json_value **out)
+{
+    ASSERT(src != NULL,
+           "raku_json_parse_arena: src must not be NULL!");
+    ASSERT(arena != NULL,
+           "raku_json_parse_arena: arena must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_parse_arena: out must not be NULL!");
 
-        else
-            *out = value;
-    }
+    struct json_error error;
+    return raku_json_parse_arena_err(src, arena, out, &error);
+}
 
-    if (status != RAKU_OK)
-        *err = ERROR(parser.lexer.column, parser.lexer.row);
-    
-    return status;
+RAKU_API
+enum raku_status raku_json_parse_arena_err(
+    const char *src,
+    struct raku_arena *arena,
+    struct json_value **out,
+    struct json_error *err)
+{
+    ASSERT(src != NULL,
+           "raku_json_parse_arena_err: src must not be NULL!");
+    ASSERT(arena != NULL,
+           "raku_json_parse_arena_err: arena must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_parse_arena_err: out must not be NULL!");
+    ASSERT(err != NULL,
+           "raku_json_parse_arena_err: err must not be NULL!");
+
+    return parse_document(src, RAKU_JSON_PARSE_DEFAULT, arena, out, err);
+}
+
+RAKU_API
+enum raku_status raku_json_parse_opt(
+    const char *src,
+    enum json_parse_option options,
+    struct raku_arena *arena,
+    struct json_value **out,
+    struct json_error *err)
+{
+    ASSERT(src != NULL,
+           "raku_json_parse_opt: src must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_parse_opt: out must not be NULL!");
+    ASSERT(err != NULL,
+           "raku_json_parse_opt: err must not be NULL!");
+
+    return parse_document(src, options, arena, out, err);
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+#ifndef RAKU_JSON_PARSE_H
+#define RAKU_JSON_PARSE_H
+
+#include "json_values.h"
+#include "json_scan.h"
+
+#include <string.h>
+
+struct json_parser
+{
+    struct lexer
+    {
+        const char *start;
+        const char *current;
+        unsigned int column;
+        unsigned int row;
+    } lexer;
+
+    enum json_parse_option options;
+    struct raku_arena *arena;
+    struct raku_string buffer;
+
+    struct value_stack
+    {
+        struct json_value **values;
+        unsigned int count;
+        unsigned int capacity;
+    } stack;
+};
+
+static inline bool at_end(struct lexer *lexer)
+{
+    return *lexer->current == '\0';
+}
+
+static inline char advance(struct lexer *lexer)
+{
+    return ++lexer->column, *(lexer->current++);
+}
+
+static inline char peek(struct lexer *lexer)
+{
+    return *lexer->current;
+}
+
+static inline char peek_next(struct lexer *lexer)
+{
+    return lexer->current[1];
+}
+
+static inline bool is_word(const char *start, unsigned int count, const char *comp)
+{
+    return (strncmp(start, comp, count) == 0);
+}
+
+static inline bool is_whitespace(const char c)
+{
+    return
+        (c == 0x20) ||
+        (c == 0x0A) ||
+        (c == 0x0D) ||
+        (c == 0x09);
+}
+
+static inline void skip_whitespaces(struct lexer *lexer)
+{
+    if (is_whitespace(*lexer->current))
+    {
+        struct json_scan_lines lines = { .count = 0, .last = NULL };
+        const char *end = raku_json_scan_whitespaces(lexer->current, &lines);
+        if (lines.count != 0)
+        {
+            lexer->row += lines.count;
+            lexer->column = (unsigned int)(end - lines.last);
+        }
+        else
+            lexer->column += (unsigned int)(end - lexer->current);
+
+        lexer->current = end;
+    }
+
+    lexer->start = lexer->current;
+}
+
+RAKU_LOCAL
+void json_parser_init(
+    struct json_parser *parser,
+    const char *src,
+    enum json_parse_option options,
+    struct raku_arena *arena);
+
+RAKU_LOCAL
+void json_parser_free(struct json_parser *parser);
+
+/* Allocates an initialized node from the parser's arena, or the node pools. */
+RAKU_LOCAL
+enum raku_status json_parser_create_value(struct json_parser *parser, enum json_value_type type, struct json_value **out);
+
+/* Pushes a finished value (or object key) onto the parser's value stack. */
+RAKU_LOCAL
+enum raku_status json_parser_push_value(struct json_parser *parser, struct json_value *value);
+
+/* Drops the values above base, freeing them when release is set. */
+RAKU_LOCAL
+void json_parser_pop_values(struct json_parser *parser, unsigned int base, bool release);
+
+/*
+ * Decodes the string whose opening quote was just consumed. out references
+ * src directly when the string has no escape sequence, the parser's scratch
+ * buffer otherwise, and is only valid until the next string is decoded. It
+ * is not NUL-terminated in the first case.
+ */
+RAKU_LOCAL
+enum raku_status json_parser_decode_string(struct json_parser *parser, struct raku_string *out);
+
+/*
+ * Reads the string whose opening quote was just consumed into a new node.
+ * On error the lexer is left on the offending byte.
+ */
+RAKU_LOCAL
+enum raku_status json_parser_read_string(struct json_parser *parser, struct json_value **out);
+
+/*
+ * Reads the object key whose opening quote was just consumed into an atom,
+ * see json_atoms.h.
+ */
+RAKU_LOCAL
+enum raku_status json_parser_read_key(struct json_parser *parser, struct json_value **out);
+
+/* Reads the value at the lexer, leaving whatever follows it untouched. */
+RAKU_LOCAL
+enum raku_status json_parser_read_value(struct json_parser *parser, struct json_value **out);
+
+/*
+ * Build an array from the values above base, or an object from the
+ * key/value pairs above base. The stack itself is left untouched.
+ */
+RAKU_LOCAL
+enum raku_status json_parser_finish_array(struct json_parser *parser, unsigned int base, struct json_value **out);
+
+RAKU_LOCAL
+enum raku_status json_parser_finish_object(struct json_parser *parser, unsigned int base, struct json_value **out);
+
+#endif
\ No newline at end of file
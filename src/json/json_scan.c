@@ -0,0 +1,453 @@
+#include "json_scan.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define SCAN_SSE2
+    #endif
+
+    #if defined(__GNUC__) || defined(__clang__)
+        #define SCAN_AVX2
+        #define TARGET_AVX2 __attribute__((target("avx2")))
+    #elif defined(_MSC_VER)
+        #define SCAN_AVX2
+        #define TARGET_AVX2
+        #include <intrin.h>
+    #endif
+
+    #include <immintrin.h>
+#endif
+
+/* Keeps AddressSanitizer off the aligned over-reads described below. */
+#if defined(__clang__) || defined(__GNUC__)
+    #define NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#elif defined(_MSC_VER) && defined(__SANITIZE_ADDRESS__)
+    #define NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+#else
+    #define NO_SANITIZE_ADDRESS
+#endif
+
+typedef const char* (*scan_whitespaces_fn)(const char *src, struct json_scan_lines *lines);
+typedef const char* (*scan_string_fn)(const char *src);
+typedef const char* (*scan_structure_fn)(const char *src);
+
+struct scanners
+{
+    scan_whitespaces_fn whitespaces;
+    scan_string_fn string;
+    scan_structure_fn structure;
+};
+
+static inline unsigned int lowest_bit(uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned int)index;
+#else
+    return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+static inline unsigned int highest_bit(uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (unsigned int)index;
+#else
+    return 31U - (unsigned int)__builtin_clz(mask);
+#endif
+}
+
+static inline unsigned int count_bits(uint32_t mask)
+{
+    mask = mask - ((mask >> 1) & 0x55555555U);
+    mask = (mask & 0x33333333U) + ((mask >> 2) & 0x33333333U);
+    return (((mask + (mask >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+}
+
+static inline void count_lines(struct json_scan_lines *lines, const char *block, uint32_t mask)
+{
+    if (mask != 0)
+    {
+        lines->count += count_bits(mask);
+        lines->last = block + highest_bit(mask);
+    }
+}
+
+static const char* scan_whitespaces_scalar(const char *src, struct json_scan_lines *lines)
+{
+    while (true)
+    {
+        switch (*src)
+        {
+            case 0x0A:
+                ++lines->count;
+                lines->last = src;
+                /* fallthrough */
+            case 0x09:
+            case 0x0D:
+            case 0x20:
+                ++src;
+                continue;
+        }
+
+        return src;
+    }
+}
+
+static const char* scan_string_scalar(const char *src)
+{
+    while ((unsigned char)*src >= 0x20 && *src != '"' && *src != '\\')
+        ++src;
+    return src;
+}
+
+static const char* scan_structure_scalar(const char *src)
+{
+    while (true)
+    {
+        switch (*src)
+        {
+            case '\0':
+            case '"':
+            case '[':
+            case ']':
+            case '{':
+            case '}':
+                return src;
+        }
+
+        ++src;
+    }
+}
+
+/*
+ * The vectorized scanners only issue aligned loads. An aligned block never
+ * straddles a page boundary, so reading the whole blocks that hold src and
+ * the terminating NUL cannot fault even though they may extend before and
+ * past the string. The bytes before src are masked out and every scanner
+ * stops at the NUL, so those outside bytes never affect the result.
+ */
+
+#if defined(SCAN_SSE2)
+NO_SANITIZE_ADDRESS
+static const char* scan_whitespaces_sse2(const char *src, struct json_scan_lines *lines)
+{
+    const char *block = (const char*)((uintptr_t)src & ~(uintptr_t)15);
+    uint32_t valid = (0xFFFFU << (src - block)) & 0xFFFFU;
+
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i tab = _mm_set1_epi8(0x09);
+    const __m128i lf = _mm_set1_epi8(0x0A);
+    const __m128i cr = _mm_set1_epi8(0x0D);
+
+    while (true)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i*)block);
+        __m128i newlines = _mm_cmpeq_epi8(chunk, lf);
+        __m128i whitespaces = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), newlines)
+        );
+
+        uint32_t newline_mask = (uint32_t)_mm_movemask_epi8(newlines) & valid;
+        uint32_t stop_mask = ~(uint32_t)_mm_movemask_epi8(whitespaces) & valid;
+        if (stop_mask != 0)
+        {
+            unsigned int stop = lowest_bit(stop_mask);
+            count_lines(lines, block, newline_mask & ((1U << stop) - 1));
+            return block + stop;
+        }
+
+        count_lines(lines, block, newline_mask);
+        block += 16;
+        valid = 0xFFFFU;
+    }
+}
+
+NO_SANITIZE_ADDRESS
+static const char* scan_string_sse2(const char *src)
+{
+    const char *block = (const char*)((uintptr_t)src & ~(uintptr_t)15);
+    uint32_t valid = (0xFFFFU << (src - block)) & 0xFFFFU;
+
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    while (true)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i*)block);
+        __m128i specials = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control)
+        );
+
+        uint32_t stop_mask = (uint32_t)_mm_movemask_epi8(specials) & valid;
+        if (stop_mask != 0)
+            return block + lowest_bit(stop_mask);
+
+        block += 16;
+        valid = 0xFFFFU;
+    }
+}
+
+/* '[' and ']' differ from '{' and '}' only by bit 5, so each pair is one compare. */
+NO_SANITIZE_ADDRESS
+static const char* scan_structure_sse2(const char *src)
+{
+    const char *block = (const char*)((uintptr_t)src & ~(uintptr_t)15);
+    uint32_t valid = (0xFFFFU << (src - block)) & 0xFFFFU;
+
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i nul = _mm_setzero_si128();
+    const __m128i fold = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+
+    while (true)
+    {
+        __m128i chunk = _mm_load_si128((const __m128i*)block);
+        __m128i folded = _mm_or_si128(chunk, fold);
+        __m128i specials = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, nul)),
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close))
+        );
+
+        uint32_t stop_mask = (uint32_t)_mm_movemask_epi8(specials) & valid;
+        if (stop_mask != 0)
+            return block + lowest_bit(stop_mask);
+
+        block += 16;
+        valid = 0xFFFFU;
+    }
+}
+#endif
+
+#if defined(SCAN_AVX2)
+TARGET_AVX2 NO_SANITIZE_ADDRESS
+static const char* scan_whitespaces_avx2(const char *src, struct json_scan_lines *lines)
+{
+    const char *block = (const char*)((uintptr_t)src & ~(uintptr_t)31);
+    uint32_t valid = 0xFFFFFFFFU << (src - block);
+
+    const __m256i space = _mm256_set1_epi8(0x20);
+    const __m256i tab = _mm256_set1_epi8(0x09);
+    const __m256i lf = _mm256_set1_epi8(0x0A);
+    const __m256i cr = _mm256_set1_epi8(0x0D);
+
+    while (true)
+    {
+        __m256i chunk = _mm256_load_si256((const __m256i*)block);
+        __m256i newlines = _mm256_cmpeq_epi8(chunk, lf);
+        __m256i whitespaces = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), newlines)
+        );
+
+        uint32_t newline_mask = (uint32_t)_mm256_movemask_epi8(newlines) & valid;
+        uint32_t stop_mask = ~(uint32_t)_mm256_movemask_epi8(whitespaces) & valid;
+        if (stop_mask != 0)
+        {
+            unsigned int stop = lowest_bit(stop_mask);
+            count_lines(lines, block, newline_mask & ((1U << stop) - 1));
+            return block + stop;
+        }
+
+        count_lines(lines, block, newline_mask);
+        block += 32;
+        valid = 0xFFFFFFFFU;
+    }
+}
+
+TARGET_AVX2 NO_SANITIZE_ADDRESS
+static const char* scan_string_avx2(const char *src)
+{
+    const char *block = (const char*)((uintptr_t)src & ~(uintptr_t)31);
+    uint32_t valid = 0xFFFFFFFFU << (src - block);
+
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+
+    while (true)
+    {
+        __m256i chunk = _mm256_load_si256((const __m256i*)block);
+        __m256i specials = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control)
+        );
+
+        uint32_t stop_mask = (uint32_t)_mm256_movemask_epi8(specials) & valid;
+        if (stop_mask != 0)
+            return block + lowest_bit(stop_mask);
+
+        block += 32;
+        valid = 0xFFFFFFFFU;
+    }
+}
+
+TARGET_AVX2 NO_SANITIZE_ADDRESS
+static const char* scan_structure_avx2(const char *src)
+{
+    const char *block = (const char*)((uintptr_t)src & ~(uintptr_t)31);
+    uint32_t valid = 0xFFFFFFFFU << (src - block);
+
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i nul = _mm256_setzero_si256();
+    const __m256i fold = _mm256_set1_epi8(0x20);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+
+    while (true)
+    {
+        __m256i chunk = _mm256_load_si256((const __m256i*)block);
+        __m256i folded = _mm256_or_si256(chunk, fold);
+        __m256i specials = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, nul)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close))
+        );
+
+        uint32_t stop_mask = (uint32_t)_mm256_movemask_epi8(specials) & valid;
+        if (stop_mask != 0)
+            return block + lowest_bit(stop_mask);
+
+        block += 32;
+        valid = 0xFFFFFFFFU;
+    }
+}
+
+static bool has_avx2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+        return false;
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+static const char* scan_whitespaces_dispatch(const char *src, struct json_scan_lines *lines);
+static const char* scan_string_dispatch(const char *src);
+static const char* scan_structure_dispatch(const char *src);
+
+static const struct scanners dispatch_scanners =
+{
+    .whitespaces = scan_whitespaces_dispatch,
+    .string = scan_string_dispatch,
+    .structure = scan_structure_dispatch
+};
+
+static const struct scanners scalar_scanners =
+{
+    .whitespaces = scan_whitespaces_scalar,
+    .string = scan_string_scalar,
+    .structure = scan_structure_scalar
+};
+
+#if defined(SCAN_SSE2)
+static const struct scanners sse2_scanners =
+{
+    .whitespaces = scan_whitespaces_sse2,
+    .string = scan_string_sse2,
+    .structure = scan_structure_sse2
+};
+#endif
+
+#if defined(SCAN_AVX2)
+static const struct scanners avx2_scanners =
+{
+    .whitespaces = scan_whitespaces_avx2,
+    .string = scan_string_avx2,
+    .structure = scan_structure_avx2
+};
+#endif
+
+/*
+ * Starts out on the dispatch set, which picks the best set on first use.
+ * Threads racing through that first use all pick the same set, and every
+ * set is immutable, so publishing the pointer is all that needs ordering.
+ */
+static const struct scanners *active_scanners = &dispatch_scanners;
+
+static inline const struct scanners* load_scanners(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (const struct scanners*)_InterlockedCompareExchangePointer((void* volatile*)&active_scanners, NULL, NULL);
+#else
+    return __atomic_load_n(&active_scanners, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void store_scanners(const struct scanners *scanners)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchangePointer((void* volatile*)&active_scanners, (void*)scanners);
+#else
+    __atomic_store_n(&active_scanners, scanners, __ATOMIC_RELEASE);
+#endif
+}
+
+static const struct scanners* select_scanners(void)
+{
+    const struct scanners *scanners = &scalar_scanners;
+
+#if defined(SCAN_SSE2)
+    scanners = &sse2_scanners;
+#endif
+
+#if defined(SCAN_AVX2)
+    if (has_avx2())
+        scanners = &avx2_scanners;
+#endif
+
+    store_scanners(scanners);
+    return scanners;
+}
+
+static const char* scan_whitespaces_dispatch(const char *src, struct json_scan_lines *lines)
+{
+    return select_scanners()->whitespaces(src, lines);
+}
+
+static const char* scan_string_dispatch(const char *src)
+{
+    return select_scanners()->string(src);
+}
+
+static const char* scan_structure_dispatch(const char *src)
+{
+    return select_scanners()->structure(src);
+}
+
+RAKU_LOCAL
+const char* raku_json_scan_whitespaces(const char *src, struct json_scan_lines *lines)
+{
+    return load_scanners()->whitespaces(src, lines);
+}
+
+RAKU_LOCAL
+const char* raku_json_scan_string(const char *src)
+{
+    return load_scanners()->string(src);
+}
+
+RAKU_LOCAL
+const char* raku_json_scan_structure(const char *src)
+{
+    return load_scanners()->structure(src);
+}
\ No newline at end of file
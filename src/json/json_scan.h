@@ -0,0 +1,36 @@
+#ifndef RAKU_JSON_SCAN_H
+#define RAKU_JSON_SCAN_H
+
+#include <RAKU/export.h>
+#include <RAKU/core/defs.h>
+
+struct json_scan_lines
+{
+    unsigned int count;
+    const char *last;
+};
+
+/*
+ * Returns the first byte at or after src that is not JSON whitespace.
+ * lines->count is increased by the number of line feeds skipped and
+ * lines->last points to the last of them (left untouched if none).
+ */
+RAKU_LOCAL
+const char* raku_json_scan_whitespaces(const char *src, struct json_scan_lines *lines);
+
+/*
+ * Returns the first byte at or after src that cannot be copied verbatim
+ * into a string value: '"', '\\' or a control character (including the
+ * terminating NUL).
+ */
+RAKU_LOCAL
+const char* raku_json_scan_string(const char *src);
+
+/*
+ * Returns the first byte at or after src that is a quote, a bracket or a
+ * brace, or the terminating NUL.
+ */
+RAKU_LOCAL
+const char* raku_json_scan_structure(const char *src);
+
+#endif
\ No newline at end of file
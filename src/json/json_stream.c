@@ -0,0 +1,493 @@
+#include <RAKU/json.h>
+#include "json_parse.h"
+#include "json_number.h"
+#include <RAKU/core/memory.h>
+#include <RAKU/debug.h>
+
+#include <limits.h>
+#include <string.h>
+
+#define FRAME_BASE_CAPACITY 16
+
+#define ERROR(c, r) ((struct json_error) { .column = (c), .row = (r) })
+
+enum stream_state
+{
+    STREAM_VALUE,
+    STREAM_FIRST_VALUE, /* A value or ']'. */
+    STREAM_KEY,
+    STREAM_FIRST_KEY,   /* A key or '}'. */
+    STREAM_COLON,
+    STREAM_SEPARATOR,   /* ',' or the closing bracket of the innermost frame. */
+    STREAM_DONE
+};
+
+struct stream_frame
+{
+    uint8_t type;
+    unsigned int base;
+};
+
+/*
+ * The unconsumed tail of the input is kept NUL-terminated in input so the
+ * parser's lexer runs on it unchanged. A token cut by the end of a chunk is
+ * rewound and read again once more bytes arrive. Open arrays and objects
+ * live on an explicit frame stack, their elements on the parser's value
+ * stack, so nesting depth is not bound by the C stack.
+ */
+struct json_stream
+{
+    struct json_parser parser;
+    struct raku_string input;
+
+    struct stream_frame *frames;
+    unsigned int depth;
+    unsigned int capacity;
+
+    uint8_t state;
+    bool pending_string;
+    struct json_value *root;
+
+    enum raku_status status;
+    struct json_error error;
+};
+
+static enum raku_status read_literal(struct lexer *lexer, const char *end, const char *word, unsigned int size)
+{
+    unsigned int available = (unsigned int)(end - lexer->current);
+    if (available < size)
+    {
+        return
+            (memcmp(lexer->current, word, available) == 0) ?
+                RAKU_JSON_INCOMPLETE :
+                RAKU_JSON_UNEXPECTED_SYMBOL;
+    }
+
+    if (memcmp(lexer->current, word, size) != 0)
+        return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+    lexer->current += size;
+    lexer->column += size;
+    return RAKU_OK;
+}
+
+/* Reads the string or key at the lexer. */
+static enum raku_status read_string(struct json_stream *stream, bool key, struct json_value **out)
+{
+    struct json_parser *parser = &stream->parser;
+    advance(&parser->lexer);
+
+    enum raku_status status =
+        key ?
+            json_parser_read_key(parser, out) :
+            json_parser_read_string(parser, out);
+
+    /* Every way a string can fail at the end of the input is a cut token. */
+    if (status != RAKU_OK && parser->lexer.current >= raku_string_chars(&stream->input) + stream->input.count)
+        status = RAKU_JSON_INCOMPLETE;
+    return status;
+}
+
+static enum raku_status read_value(struct json_stream *stream, bool final, struct json_value **out)
+{
+    struct json_parser *parser = &stream->parser;
+    struct lexer *lexer = &parser->lexer;
+    const char *end = raku_string_chars(&stream->input) + stream->input.count;
+
+    enum raku_status status;
+    switch (peek(lexer))
+    {
+        case 'n':
+            *out = raku_json_null();
+            return read_literal(lexer, end, "null", 4);
+        case 'f':
+        case 't':
+        {
+            bool value = (peek(lexer) == 't');
+            status = read_literal(lexer, end, value ? "true" : "false", value ? 4 : 5);
+            if (status == RAKU_OK)
+                *out = (struct json_value*)(value ? raku_json_true() : raku_json_false());
+            return status;
+        }
+        case '"':
+            return read_string(stream, false, out);
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '-':
+        {
+            const char *number_end;
+            struct json_number read;
+            status = raku_json_number_read(lexer->current, &number_end, &read);
+
+            /* More digits may follow in the next chunk. */
+            if (number_end >= end && !final)
+                return RAKU_JSON_INCOMPLETE;
+
+            lexer->column += (unsigned int)(number_end - lexer->current);
+            lexer->current = number_end;
+            if (status != RAKU_OK)
+                return status;
+
+            struct json_number *number;
+            status = json_parser_create_value(parser, RAKU_JSON_NUMBER, (struct json_value**)&number);
+            if (status == RAKU_OK)
+            {
+                number->kind = read.kind;
+                number->value = read.value;
+                *out = (struct json_value*)number;
+            }
+            return status;
+        }
+        default:
+            return RAKU_JSON_UNEXPECTED_SYMBOL;
+    }
+}
+
+static enum raku_status emit_value(struct json_stream *stream, struct json_value *value)
+{
+    if (stream->depth == 0)
+    {
+        stream->root = value;
+        stream->state = STREAM_DONE;
+        return RAKU_OK;
+    }
+
+    enum raku_status status = json_parser_push_value(&stream->parser, value);
+    if (status != RAKU_OK)
+        raku_json_value_free(value);
+
+    stream->state = STREAM_SEPARATOR;
+    return status;
+}
+
+static enum raku_status open_frame(struct json_stream *stream, enum json_value_type type)
+{
+    if (stream->depth == stream->capacity)
+    {
+        if (stream->capacity > (UINT_MAX / 2))
+            return RAKU_NO_MEMORY;
+
+        unsigned int new_capacity =
+            (stream->capacity < FRAME_BASE_CAPACITY) ?
+                FRAME_BASE_CAPACITY :
+                2 * stream->capacity;
+
+        enum raku_status status = raku_realloc(
+            stream->frames,
+            stream->capacity * sizeof(struct stream_frame),
+            new_capacity * sizeof(struct stream_frame),
+            (void**)&stream->frames
+        );
+
+        if (status != RAKU_OK)
+            return status;
+
+        stream->capacity = new_capacity;
+    }
+
+    stream->frames[stream->depth++] = (struct stream_frame) {
+        .type = (uint8_t)type,
+        .base = stream->parser.stack.count
+    };
+
+    stream->state = (type == RAKU_JSON_ARRAY) ? STREAM_FIRST_VALUE : STREAM_FIRST_KEY;
+    return RAKU_OK;
+}
+
+static enum raku_status close_frame(struct json_stream *stream)
+{
+    struct stream_frame frame = stream->frames[--stream->depth];
+
+    struct json_value *value;
+    enum raku_status status =
+        (frame.type == RAKU_JSON_ARRAY) ?
+            json_parser_finish_array(&stream->parser, frame.base, &value) :
+            json_parser_finish_object(&stream->parser, frame.base, &value);
+
+    json_parser_pop_values(&stream->parser, frame.base, status != RAKU_OK);
+    if (status != RAKU_OK)
+        return status;
+
+    return emit_value(stream, value);
+}
+
+static enum raku_status step(struct json_stream *stream, bool final)
+{
+    struct lexer *lexer = &stream->parser.lexer;
+    struct json_value *value;
+    enum raku_status status;
+
+    char c = peek(lexer);
+    switch (stream->state)
+    {
+        case STREAM_FIRST_VALUE:
+            if (c == ']')
+            {
+                advance(lexer);
+                return close_frame(stream);
+            }
+            /* fallthrough */
+        case STREAM_VALUE:
+            if (c == '[' || c == '{')
+            {
+                advance(lexer);
+                return open_frame(stream, (c == '[') ? RAKU_JSON_ARRAY : RAKU_JSON_OBJECT);
+            }
+
+            status = read_value(stream, final, &value);
+            if (status != RAKU_OK)
+                return status;
+
+            return emit_value(stream, value);
+        case STREAM_FIRST_KEY:
+            if (c == '}')
+            {
+                advance(lexer);
+                return close_frame(stream);
+            }
+            /* fallthrough */
+        case STREAM_KEY:
+            if (c != '"')
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+            status = read_string(stream, true, &value);
+            if (status != RAKU_OK)
+                return status;
+
+            status = json_parser_push_value(&stream->parser, value);
+            if (status != RAKU_OK)
+            {
+                raku_json_value_free(value);
+                return status;
+            }
+
+            stream->state = STREAM_COLON;
+            return RAKU_OK;
+        case STREAM_COLON:
+            if (c != ':')
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+            advance(lexer);
+            stream->state = STREAM_VALUE;
+            return RAKU_OK;
+        case STREAM_SEPARATOR:
+        {
+            bool array = (stream->frames[stream->depth-1].type == RAKU_JSON_ARRAY);
+            if (c == ',')
+            {
+                advance(lexer);
+                stream->state = array ? STREAM_VALUE : STREAM_KEY;
+                return RAKU_OK;
+            }
+
+            if (c != (array ? ']' : '}'))
+                return RAKU_JSON_UNEXPECTED_SYMBOL;
+
+            advance(lexer);
+            return close_frame(stream);
+        }
+        default:
+            return RAKU_JSON_EXPECTED_END;
+    }
+}
+
+static enum raku_status run(struct json_stream *stream, bool final)
+{
+    if (stream->input.count == 0)
+        return (stream->state == STREAM_DONE) ? RAKU_OK : RAKU_JSON_INCOMPLETE;
+
+    struct lexer *lexer = &stream->parser.lexer;
+    char *input = raku_string_chars(&stream->input);
+    const char *end = input + stream->input.count;
+    lexer->current = input;
+    stream->pending_string = false;
+
+    enum raku_status status;
+    while (true)
+    {
+        skip_whitespaces(lexer);
+        if (lexer->current == end)
+        {
+            status = (stream->state == STREAM_DONE) ? RAKU_OK : RAKU_JSON_INCOMPLETE;
+            break;
+        }
+
+        struct lexer token = *lexer;
+        status = step(stream, final);
+        if (status == RAKU_JSON_INCOMPLETE)
+        {
+            *lexer = token;
+            stream->pending_string = (peek(lexer) == '"');
+            break;
+        }
+
+        if (status != RAKU_OK)
+            break;
+    }
+
+    unsigned int consumed = (unsigned int)(lexer->current - input);
+    memmove(input, lexer->current, stream->input.count - consumed + 1);
+    stream->input.count -= consumed;
+
+    return status;
+}
+
+static enum raku_status complete(struct json_stream *stream, enum raku_status status, struct json_value **out)
+{
+    if (status == RAKU_OK)
+    {
+        *out = stream->root;
+        stream->root = NULL;
+        stream->state = STREAM_VALUE;
+    }
+
+    else if (status != RAKU_JSON_INCOMPLETE)
+    {
+        stream->status = status;
+        stream->error = ERROR(stream->parser.lexer.column, stream->parser.lexer.row);
+    }
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_stream_create(struct raku_arena *arena, struct json_stream **out)
+{
+    ASSERT(out != NULL,
+           "raku_json_stream_create: out must not be NULL!");
+
+    struct json_stream *stream;
+    enum raku_status status = raku_alloc(
+        sizeof(struct json_stream),
+        (void**)&stream
+    );
+
+    if (status == RAKU_OK)
+    {
+        json_parser_init(&stream->parser, NULL, RAKU_JSON_PARSE_DEFAULT, arena);
+        raku_string_init(&stream->input);
+
+        stream->frames = NULL;
+        stream->depth = 0;
+        stream->capacity = 0;
+
+        stream->state = STREAM_VALUE;
+        stream->pending_string = false;
+        stream->root = NULL;
+
+        stream->status = RAKU_OK;
+        stream->error = ERROR(1, 1);
+
+        *out = stream;
+    }
+
+    return status;
+}
+
+RAKU_API
+void raku_json_stream_free(struct json_stream *stream)
+{
+    if (stream == NULL)
+        return;
+
+    raku_json_stream_reset(stream);
+    json_parser_free(&stream->parser);
+    raku_string_free(&stream->input);
+    raku_free(stream->frames, stream->capacity * sizeof(struct stream_frame));
+    raku_free(stream, sizeof(struct json_stream));
+}
+
+RAKU_API
+void raku_json_stream_reset(struct json_stream *stream)
+{
+    ASSERT(stream != NULL,
+           "raku_json_stream_reset: stream must not be NULL!");
+
+    raku_json_value_free(stream->root);
+    json_parser_pop_values(&stream->parser, 0, true);
+
+    stream->parser.lexer.column = 1;
+    stream->parser.lexer.row = 1;
+
+    char *input = raku_string_chars(&stream->input);
+    if (input != NULL)
+        input[0] = '\0';
+    stream->input.count = 0;
+
+    stream->depth = 0;
+    stream->state = STREAM_VALUE;
+    stream->pending_string = false;
+    stream->root = NULL;
+
+    stream->status = RAKU_OK;
+    stream->error = ERROR(1, 1);
+}
+
+RAKU_API
+enum raku_status raku_json_stream_feed(
+    struct json_stream *stream,
+    const char *chunk,
+    size_t size,
+    struct json_value **out)
+{
+    ASSERT(stream != NULL,
+           "raku_json_stream_feed: stream must not be NULL!");
+    ASSERT(chunk != NULL || size == 0,
+           "raku_json_stream_feed: chunk must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_stream_feed: out must not be NULL!");
+
+    if (stream->status != RAKU_OK)
+        return stream->status;
+    else if (size > (UINT_MAX - stream->input.count - 8))
+        return RAKU_NO_MEMORY;
+
+    enum raku_status status = raku_string_append_n(&stream->input, chunk, (unsigned int)size);
+    if (status != RAKU_OK)
+        return status;
+
+    /* A cut string cannot close before a quote arrives: don't rescan it. */
+    if (stream->pending_string && memchr(chunk, '"', size) == NULL)
+        return RAKU_JSON_INCOMPLETE;
+
+    return complete(stream, run(stream, false), out);
+}
+
+RAKU_API
+enum raku_status raku_json_stream_finish(struct json_stream *stream, struct json_value **out)
+{
+    ASSERT(stream != NULL,
+           "raku_json_stream_finish: stream must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_stream_finish: out must not be NULL!");
+
+    if (stream->status != RAKU_OK)
+        return stream->status;
+
+    enum raku_status status = run(stream, true);
+    if (status == RAKU_JSON_INCOMPLETE)
+    {
+        stream->status = status;
+        stream->error = ERROR(stream->parser.lexer.column, stream->parser.lexer.row);
+        return status;
+    }
+
+    return complete(stream, status, out);
+}
+
+RAKU_API
+struct json_error raku_json_stream_error(struct json_stream *stream)
+{
+    ASSERT(stream != NULL,
+           "raku_json_stream_error: stream must not be NULL!");
+
+    return stream->error;
+}
\ No newline at end of file
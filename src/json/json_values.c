@@ -1,404 +1,90 @@
 #include "json_values.h"
+#include "json_atoms.h"
 
 #include <RAKU/core/memory.h>
 #include <RAKU/debug.h>
 
 #include <limits.h>
 #include <string.h>
-#include <stdio.h>
 
-#define ARRAY_BASE_CAPACITY 8
-#define OBJECT_BASE_CAPACITY 16
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define OBJECT_SSE2
+    #include <emmintrin.h>
+#endif
 
-#define OBJECT_THRESHOLD 0.6
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
 
-#define FNV_OFFSET_BASIS 2166136261U
-#define FNV_PRIME 16777619U
+#define ARRAY_BASE_CAPACITY 8
 
-static enum raku_status write_string(struct json_string *string, struct raku_string *out)
-{
-    ASSERT(raku_json_value_of_type((struct json_value*)string, RAKU_JSON_STRING),
-           "write_string: invalid string.");
+#define OBJECT_SMALL_BASE_CAPACITY 4
+#define OBJECT_SMALL_CAPACITY 8
 
-    enum raku_status status = raku_string_write(out, '"');
-    if (status != RAKU_OK)
-        goto ws_end;
-    
-    if (string->value.chars)
-    {
-        const char *c = string->value.chars;
-        while (*c != '\0')
-        {
-            switch (*c)
-            {
-            case '"':
-                status = raku_string_writesc(out, "\\\"");
-                break;
-            case '\\':
-                status = raku_string_writesc(out, "\\\\");
-                break;
-            case '/':
-                status = raku_string_writesc(out, "\\/");
-                break;
-            case '\b':
-                status = raku_string_writesc(out, "\\b");
-                break;
-            case '\f':
-                status = raku_string_writesc(out, "\\f");
-                break;
-            case '\n':
-                status = raku_string_writesc(out, "\\n");
-                break;
-            case '\r':
-                status = raku_string_writesc(out, "\\r");
-                break;
-            case '\t':
-                status = raku_string_writesc(out, "\\t");
-                break;
-            default:
-                status = raku_string_write(out, *c);
-                break;
-            }
+#define OBJECT_GROUP_SIZE 16
+#define OBJECT_MIN_BUCKETS 16
 
-            if (status != RAKU_OK)
-                goto ws_end;
-            
-            ++c;
-        }
-    }
+#define CONTROL_EMPTY 0x80
+#define CONTROL_DELETED 0xFE
 
-    status = raku_string_write(out, '"');
+/* wyhash's default secret. */
+#define HASH_SECRET0 0xa0761d6478bd642fULL
+#define HASH_SECRET1 0xe7037ed1a0b428dbULL
 
-ws_end:
-    return status;
-}
+/* The seed premixed with the secret, raku_json_hash_seed(0) by default. */
+static uint64_t hash_seed = 0x1ff5c2923a788d2cULL;
 
-static enum raku_status raku_json_value_to_string_compact(struct json_value *value, struct raku_string *out)
+RAKU_API
+enum json_value_type raku_json_value_get_type(struct json_value *value)
 {
-    switch (raku_json_value_get_type(value))
-    {
-        case RAKU_JSON_BOOL:
-            if (((struct json_bool*)value)->value)
-                return raku_string_writesc(out, "true");
-            else
-                return raku_string_writesc(out, "false");
-        case RAKU_JSON_NUMBER:
-        {
-            char n[32];
-            snprintf(n, 32, "%.24g", ((struct json_number*)value)->value);
-            return raku_string_writesc(out, n);
-        }
-        default:
-            ASSERT(false, "raku_json_value_to_string_compact: invalid json value.");
-        case RAKU_JSON_NULL:
-            return raku_string_writesc(out, "null");
-        case RAKU_JSON_STRING:
-            return write_string((struct json_string*)value, out);
-        case RAKU_JSON_ARRAY:
-        {
-            enum raku_status status = raku_string_write(out, '[');
-            if (status != RAKU_OK)
-                goto rjvtsc_rjvgtv_caseRJA_end;
-            
-            struct json_array *array = (struct json_array*)value;
-            if (array->count > 0)
-            {
-                status = raku_json_value_to_string_compact(array->values[0], out);
-                if (status != RAKU_OK)
-                    goto rjvtsc_rjvgtv_caseRJA_end;
-
-                for (unsigned int i = 1; i < array->count; ++i)
-                {
-                    status = raku_string_write(out, ',');
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJA_end;
-                    
-                    status = raku_json_value_to_string_compact(array->values[i], out);
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJA_end;
-                }
-            }
-
-            status = raku_string_write(out, ']');
-
-        rjvtsc_rjvgtv_caseRJA_end:
-            return status;
-        }
-        case RAKU_JSON_OBJECT:
-        {
-            enum raku_status status = raku_string_write(out, '{');
-            if (status != RAKU_OK)
-                goto rjvtsc_rjvgtv_caseRJO_end;
-            
-            struct json_object *object = (struct json_object*)value;
-            if (object->count > 0)
-            {
-                unsigned int i = 0;
-                unsigned int count = 0;
-                for (; i < object->capacity && count != 1; ++i)
-                {
-                    if (object->keys[i].value.chars == NULL)
-                        continue;
-
-                    status = write_string(object->keys+i, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJO_end;
-                    
-                    status = raku_string_write(out, ':');
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJO_end;
-                    
-                    status = raku_json_value_to_string_compact(object->values[i], out);
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJO_end;
-                    
-                    ++count;
-                }
-
-                for (; i < object->capacity && count < object->count; ++i)
-                {
-                    if (object->keys[i].value.chars == NULL)
-                        continue;
-
-                    status = raku_string_write(out, ',');
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJO_end;
-
-                    status = write_string(object->keys+i, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJO_end;
-                    
-                    status = raku_string_write(out, ':');
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJO_end;
-                    
-                    status = raku_json_value_to_string_compact(object->values[i], out);
-                    if (status != RAKU_OK)
-                        goto rjvtsc_rjvgtv_caseRJO_end;
-                    
-                    ++count;
-                }
-            }
-
-            status = raku_string_write(out, '}');
-            
-        rjvtsc_rjvgtv_caseRJO_end:
-            return status;
-        }
-    }
+    return value ? value->type : RAKU_JSON_NULL;
 }
 
-static enum raku_status write_indent(const char *indent, unsigned int level, struct raku_string *out)
+RAKU_API
+bool raku_json_value_of_type(struct json_value *value, enum json_value_type type)
 {
-    enum raku_status status = RAKU_OK;
-    for (unsigned int i = 0; i < level; ++i)
-    {
-        status = raku_string_writesc(out, indent);
-        if (status != RAKU_OK)
-            break;
-    }
-    return status;
+    return value ? value->type == type : type == RAKU_JSON_NULL;
 }
 
-static enum raku_status raku_json_value_to_string_indent(
-    struct json_value *value,
-    const char *indent,
-    unsigned int level,
-    struct raku_string *out)
-{
-    switch (raku_json_value_get_type(value))
-    {
-        case RAKU_JSON_BOOL:
-            if (((struct json_bool*)value)->value)
-                return raku_string_writesc(out, "true");
-            else
-                return raku_string_writesc(out, "false");
-        case RAKU_JSON_NUMBER:
-        {
-            char n[32];
-            snprintf(n, 32, "%.24g", ((struct json_number*)value)->value);
-            return raku_string_writesc(out, n);
-        }
-        default:
-            ASSERT(false, "raku_json_value_to_string_compact: invalid json value.");
-        case RAKU_JSON_NULL:
-            return raku_string_writesc(out, "null");
-        case RAKU_JSON_STRING:
-            return write_string((struct json_string*)value, out);
-        case RAKU_JSON_ARRAY:
-        {
-            enum raku_status status = raku_string_write(out, '[');
-            if (status != RAKU_OK)
-                goto rjvtsi_rjvgtv_caseRJA_end;
-            
-            struct json_array *array = (struct json_array*)value;
-            if (array->count > 0)
-            {
-                status = raku_string_write(out, '\n');
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJA_end;
-
-                status = write_indent(indent, level+1, out);
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJA_end;
-
-                status = raku_json_value_to_string_indent(array->values[0], indent, level+1, out);
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJA_end;
-
-                for (unsigned int i = 1; i < array->count; ++i)
-                {
-                    status = raku_string_writesc(out, ",\n");
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJA_end;
-
-                    status = write_indent(indent, level+1, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJA_end;
-
-                    status = raku_json_value_to_string_indent(array->values[i], indent, level+1, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJA_end;
-                }
-
-                status = raku_string_write(out, '\n');
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJA_end;
-
-                status = write_indent(indent, level, out);
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJA_end;
-            }
-
-            status = raku_string_write(out, ']');
+/* Literals carry no state of their own, so every tree shares these. */
+static struct json_value null_node = {
+    .type = RAKU_JSON_NULL,
+    .flags = RAKU_JSON_FLAG_SHARED
+};
 
-        rjvtsi_rjvgtv_caseRJA_end:
-            return status;
-        }
-        case RAKU_JSON_OBJECT:
-        {
-            enum raku_status status = raku_string_write(out, '{');
-            if (status != RAKU_OK)
-                goto rjvtsi_rjvgtv_caseRJO_end;
-            
-            struct json_object *object = (struct json_object*)value;
-            if (object->count > 0)
-            {
-                status = raku_string_write(out, '\n');
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJO_end;
-                
-                status = write_indent(indent, level+1, out);
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJO_end;
-
-                unsigned int i = 0;
-                unsigned int count = 0;
-                for (; i < object->capacity && count != 1; ++i)
-                {
-                    if (object->keys[i].value.chars == NULL)
-                        continue;
-
-                    status = write_string(object->keys+i, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-                    
-                    status = raku_string_writesc(out, ": ");
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-                    
-                    status = raku_json_value_to_string_indent(object->values[i], indent, level+1, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-                    
-                    ++count;
-                }
-
-                for (; i < object->capacity && count < object->count; ++i)
-                {
-                    if (object->keys[i].value.chars == NULL)
-                        continue;
-
-                    status = raku_string_writesc(out, ",\n");
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-                    
-                    status = write_indent(indent, level+1, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-
-                    status = write_string(object->keys+i, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-                    
-                    status = raku_string_writesc(out, ": ");
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-                    
-                    status = raku_json_value_to_string_indent(object->values[i], indent, level+1, out);
-                    if (status != RAKU_OK)
-                        goto rjvtsi_rjvgtv_caseRJO_end;
-                    
-                    ++count;
-                }
-
-                status = raku_string_write(out, '\n');
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJO_end;
-                
-                status = write_indent(indent, level, out);
-                if (status != RAKU_OK)
-                    goto rjvtsi_rjvgtv_caseRJO_end;
-            }
+static struct json_bool true_node = {
+    ._header = { .type = RAKU_JSON_BOOL, .flags = RAKU_JSON_FLAG_SHARED },
+    .value = true
+};
 
-            status = raku_string_write(out, '}');
-            
-        rjvtsi_rjvgtv_caseRJO_end:
-            return status;
-        }
-    }
-}
+static struct json_bool false_node = {
+    ._header = { .type = RAKU_JSON_BOOL, .flags = RAKU_JSON_FLAG_SHARED },
+    .value = false
+};
 
 RAKU_API
-enum raku_status raku_json_value_to_string(struct json_value *value, enum json_format_option options, struct raku_string *out)
+struct json_value* raku_json_null(void)
 {
-    struct raku_string string;
-    raku_string_init(&string);
-
-    enum raku_status status = RAKU_OK;
-    if ((options & 0x3) == RAKU_JSON_FORMAT_COMPACT)
-        status = raku_json_value_to_string_compact(value, &string);
-    else if ((options & 0x3) == RAKU_JSON_FORMAT_INDENT2)
-        status = raku_json_value_to_string_indent(value, "  ", 0, &string);
-    else if ((options & 0x3) == RAKU_JSON_FORMAT_INDENT4)
-        status = raku_json_value_to_string_indent(value, "    ", 0, &string);
-    else if ((options & 0x3) == RAKU_JSON_FORMAT_TAB)
-        status = raku_json_value_to_string_indent(value, "\t", 0, &string);
-    
-    if (status == RAKU_OK)
-        raku_string_own(out, &string);
-    else
-        raku_string_free(&string);
-    
-    return status;
+    return &null_node;
 }
 
 RAKU_API
-enum json_value_type raku_json_value_get_type(struct json_value *value)
+struct json_bool* raku_json_true(void)
 {
-    return value ? value->type : RAKU_JSON_NULL;
+    return &true_node;
 }
 
 RAKU_API
-bool raku_json_value_of_type(struct json_value *value, enum json_value_type type)
+struct json_bool* raku_json_false(void)
 {
-    return value ? value->type == type : type == RAKU_JSON_NULL;
+    return &false_node;
 }
 
 RAKU_LOCAL
 void raku_json_bool_init(struct json_bool *boolean)
 {
     boolean->_header.type = RAKU_JSON_BOOL;
+    boolean->_header.flags = 0;
     boolean->value = 0;
 }
 
@@ -406,14 +92,17 @@ RAKU_LOCAL
 void raku_json_number_init(struct json_number *number)
 {
     number->_header.type = RAKU_JSON_NUMBER;
-    number->value = 0;
+    number->_header.flags = 0;
+    number->kind = RAKU_JSON_NUMBER_DOUBLE;
+    number->value.real = 0;
 }
 
 RAKU_LOCAL
 void raku_json_string_init(struct json_string *string)
 {
     string->_header.type = RAKU_JSON_STRING;
-    string->hash = FNV_OFFSET_BASIS;
+    string->_header.flags = 0;
+    string->hash = raku_json_hash(NULL, 0);
     raku_string_init(&string->value);
 }
 
@@ -421,6 +110,8 @@ RAKU_LOCAL
 void raku_json_array_init(struct json_array *array)
 {
     array->_header.type = RAKU_JSON_ARRAY;
+    array->_header.flags = 0;
+    array->kind = RAKU_JSON_ARRAY_VALUES;
     array->values = NULL;
     array->count = 0;
     array->capacity = 0;
@@ -430,17 +121,65 @@ RAKU_LOCAL
 void raku_json_object_init(struct json_object *object)
 {
     object->_header.type = RAKU_JSON_OBJECT;
-    object->keys = NULL;
-    object->values = NULL;
+    object->_header.flags = 0;
+    object->members = NULL;
     object->count = 0;
+    object->used = 0;
     object->capacity = 0;
+    object->mask = 0;
+}
+
+static size_t element_size(uint8_t kind)
+{
+    switch (kind)
+    {
+        case RAKU_JSON_ARRAY_DOUBLES:
+            return sizeof(double);
+        case RAKU_JSON_ARRAY_INT64S:
+            return sizeof(int64_t);
+        case RAKU_JSON_ARRAY_BOOLS:
+            return sizeof(bool);
+        default:
+            return sizeof(struct json_value*);
+    }
+}
+
+/* Size of the block array->values points to. */
+static inline size_t array_storage_size(const struct json_array *array)
+{
+    return (size_t)array->capacity * element_size(array->kind);
+}
+
+static inline size_t object_storage_size(const struct json_object *object)
+{
+    return raku_json_object_storage_size(object->capacity, (object->mask == 0) ? 0 : object->mask + 1);
+}
+
+RAKU_LOCAL
+size_t raku_json_node_size(enum json_value_type type)
+{
+    switch (type)
+    {
+        case RAKU_JSON_BOOL:
+            return sizeof(struct json_bool);
+        case RAKU_JSON_NUMBER:
+            return sizeof(struct json_number);
+        case RAKU_JSON_STRING:
+            return sizeof(struct json_string);
+        case RAKU_JSON_ARRAY:
+            return sizeof(struct json_array);
+        case RAKU_JSON_OBJECT:
+            return sizeof(struct json_object);
+        default:
+            return 0;
+    }
 }
 
 RAKU_API
 enum raku_status raku_json_bool_create(struct json_bool **out)
 {
     struct json_bool *boolean;
-    enum raku_status status = raku_alloc(
+    enum raku_status status = raku_pool_alloc(
         sizeof(struct json_bool),
         (void**)&boolean
     );
@@ -458,7 +197,7 @@ RAKU_API
 enum raku_status raku_json_number_create(struct json_number **out)
 {
     struct json_number *number;
-    enum raku_status status = raku_alloc(
+    enum raku_status status = raku_pool_alloc(
         sizeof(struct json_number),
         (void**)&number
     );
@@ -476,7 +215,7 @@ RAKU_API
 enum raku_status raku_json_string_create(struct json_string **out)
 {
     struct json_string *string;
-    enum raku_status status = raku_alloc(
+    enum raku_status status = raku_pool_alloc(
         sizeof(struct json_string),
         (void**)&string
     );
@@ -494,7 +233,7 @@ RAKU_API
 enum raku_status raku_json_array_create(struct json_array **out)
 {
     struct json_array *array;
-    enum raku_status status = raku_alloc(
+    enum raku_status status = raku_pool_alloc(
         sizeof(struct json_array),
         (void**)&array
     );
@@ -512,7 +251,7 @@ RAKU_API
 enum raku_status raku_json_object_create(struct json_object **out)
 {
     struct json_object *object;
-    enum raku_status status = raku_alloc(
+    enum raku_status status = raku_pool_alloc(
         sizeof(struct json_object),
         (void**)&object
     );
@@ -532,7 +271,8 @@ void raku_json_string_free(struct json_string *string)
     ASSERT(raku_json_value_of_type((struct json_value*)string, RAKU_JSON_STRING),
            "raku_json_string_free: invalid string.");
 
-    raku_string_free(&string->value);
+    if (!(string->_header.flags & (RAKU_JSON_FLAG_ARENA | RAKU_JSON_FLAG_VIEW)))
+        raku_string_free(&string->value);
 }
 
 RAKU_LOCAL
@@ -541,11 +281,14 @@ void raku_json_array_free(struct json_array *array)
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
            "raku_json_array_free: invalid array.");
 
-    for (unsigned int i = 0; i < array->count; ++i)
+    if (array->kind == RAKU_JSON_ARRAY_VALUES)
     {
-        raku_json_value_free(array->values[i]);
+        for (unsigned int i = 0; i < array->count; ++i)
+        {
+            raku_json_value_free(array->values[i]);
+        }
     }
-    raku_free(array->values);
+    raku_free_for(RAKU_MEMORY_ARRAYS, array->values, array_storage_size(array));
 }
 
 RAKU_LOCAL
@@ -554,23 +297,20 @@ void raku_json_object_free(struct json_object *object)
     ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
            "raku_json_object_free: invalid object.");
 
-    for (unsigned int i = 0, count = 0;
-         i < object->capacity && count != object->count;
-         ++i)
+    for (unsigned int i = 0; i < object->used; ++i)
     {
-        if (object->keys[i].value.chars == NULL)
-            continue;
-        raku_json_string_free(object->keys+i);
-        raku_json_value_free(object->values[i]);
-        ++count;
+        raku_json_value_free((struct json_value*)object->members[i].key);
+        raku_json_value_free(object->members[i].value);
     }
-    raku_free(object->keys);
-    raku_free(object->values);
+    raku_free_for(RAKU_MEMORY_OBJECT_TABLES, object->members, object_storage_size(object));
 }
 
 RAKU_API
 void raku_json_value_free(struct json_value *value)
 {
+    if (value == NULL || (value->flags & (RAKU_JSON_FLAG_ARENA | RAKU_JSON_FLAG_INTERNED | RAKU_JSON_FLAG_SHARED)))
+        return;
+
     switch (raku_json_value_get_type(value))
     {
         case RAKU_JSON_STRING:
@@ -587,10 +327,12 @@ void raku_json_value_free(struct json_value *value)
         case RAKU_JSON_NUMBER:
             break;
         default:
-            ASSERT(false, "raku_json_value_free: invalid json value.");
-            break;
+            /* Keys own nothing besides themselves. */
+            ASSERT(value->type == RAKU_JSON_KEY, "raku_json_value_free: invalid json value.");
+            raku_free_for(RAKU_MEMORY_NODES, value, sizeof(struct json_atom) + ((struct json_atom*)value)->count + 1);
+            return;
     }
-    raku_free(value);
+    raku_pool_free(value, raku_json_node_size(value->type));
 }
 
 RAKU_API
@@ -598,6 +340,8 @@ void raku_json_bool_set(struct json_bool *boolean, bool value)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)boolean, RAKU_JSON_BOOL),
            "raku_json_bool_set: invalid boolean.");
+    ASSERT(!(boolean->_header.flags & RAKU_JSON_FLAG_SHARED),
+           "raku_json_bool_set: shared literals are read-only.");
     boolean->value = value;
 }
 
@@ -614,7 +358,8 @@ void raku_json_number_set(struct json_number *number, double value)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)number, RAKU_JSON_NUMBER),
            "raku_json_number_set: invalid number.");
-    number->value = value;
+    number->kind = RAKU_JSON_NUMBER_DOUBLE;
+    number->value.real = value;
 }
 
 RAKU_API
@@ -622,21 +367,205 @@ double raku_json_number_get(struct json_number *number)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)number, RAKU_JSON_NUMBER),
            "raku_json_number_get: invalid number.");
-    return number->value;
+
+    switch (number->kind)
+    {
+        case RAKU_JSON_NUMBER_INT64:
+            return (double)number->value.integer;
+        case RAKU_JSON_NUMBER_UINT64:
+            return (double)number->value.unsigned_integer;
+        default:
+            return number->value.real;
+    }
 }
 
-static string_hash hash_string(const char *src)
+RAKU_API
+void raku_json_number_set_int64(struct json_number *number, int64_t value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)number, RAKU_JSON_NUMBER),
+           "raku_json_number_set_int64: invalid number.");
+    number->kind = RAKU_JSON_NUMBER_INT64;
+    number->value.integer = value;
+}
+
+RAKU_API
+void raku_json_number_set_uint64(struct json_number *number, uint64_t value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)number, RAKU_JSON_NUMBER),
+           "raku_json_number_set_uint64: invalid number.");
+    number->kind = RAKU_JSON_NUMBER_UINT64;
+    number->value.unsigned_integer = value;
+}
+
+RAKU_API
+bool raku_json_number_is_integer(struct json_number *number)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)number, RAKU_JSON_NUMBER),
+           "raku_json_number_is_integer: invalid number.");
+    return number->kind != RAKU_JSON_NUMBER_DOUBLE;
+}
+
+RAKU_API
+enum raku_status raku_json_number_get_int64(struct json_number *number, int64_t *out)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)number, RAKU_JSON_NUMBER),
+           "raku_json_number_get_int64: invalid number.");
+
+    switch (number->kind)
+    {
+        case RAKU_JSON_NUMBER_INT64:
+            *out = number->value.integer;
+            return RAKU_OK;
+        case RAKU_JSON_NUMBER_UINT64:
+            if (number->value.unsigned_integer > INT64_MAX)
+                return RAKU_OUT_OF_RANGE;
+            *out = (int64_t)number->value.unsigned_integer;
+            return RAKU_OK;
+        default:
+            return RAKU_OUT_OF_RANGE;
+    }
+}
+
+RAKU_API
+enum raku_status raku_json_number_get_uint64(struct json_number *number, uint64_t *out)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)number, RAKU_JSON_NUMBER),
+           "raku_json_number_get_uint64: invalid number.");
+
+    switch (number->kind)
+    {
+        case RAKU_JSON_NUMBER_INT64:
+            if (number->value.integer < 0)
+                return RAKU_OUT_OF_RANGE;
+            *out = (uint64_t)number->value.integer;
+            return RAKU_OK;
+        case RAKU_JSON_NUMBER_UINT64:
+            *out = number->value.unsigned_integer;
+            return RAKU_OK;
+        default:
+            return RAKU_OUT_OF_RANGE;
+    }
+}
+
+/* Sets *a and *b to the low and high halves of their 128-bit product. */
+static inline void hash_multiply(uint64_t *a, uint64_t *b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)*a * *b;
+    *a = (uint64_t)product;
+    *b = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t low = t + (rm1 << 32);
+    c += low < t;
+    *a = low;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    hash_multiply(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t read64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t read32(const uint8_t *p)
 {
-    string_hash hash = FNV_OFFSET_BASIS;
-    if (src)
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* Reads 1 to 3 bytes. */
+static inline uint64_t read_small(const uint8_t *p, unsigned int count)
+{
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[count >> 1] << 8) | p[count-1];
+}
+
+/*
+ * wyhash: keys of up to 16 bytes, which is nearly every object key, are
+ * read with two overlapping loads and mixed by a single 64x64->128 bit
+ * multiplication, longer ones 16 bytes per multiplication.
+ */
+RAKU_LOCAL
+string_hash raku_json_hash(const char *src, unsigned int count)
+{
+    const uint8_t *p = (const uint8_t*)src;
+    uint64_t seed = hash_seed;
+    uint64_t a, b;
+    if (count <= 16)
+    {
+        if (count >= 4)
+        {
+            unsigned int middle = (count >> 3) << 2;
+            a = (read32(p) << 32) | read32(p+middle);
+            b = (read32(p+count-4) << 32) | read32(p+count-4-middle);
+        }
+        else if (count > 0)
+        {
+            a = read_small(p, count);
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
     {
-        while (*src != '\0')
+        unsigned int remaining = count;
+        while (remaining > 16)
         {
-            hash ^= *(src++);
-            hash *= FNV_PRIME;
+            seed = hash_mix(read64(p) ^ HASH_SECRET1, read64(p+8) ^ seed);
+            p += 16;
+            remaining -= 16;
         }
+        a = read64(p+remaining-16);
+        b = read64(p+remaining-8);
+    }
+
+    a ^= HASH_SECRET1;
+    b ^= seed;
+    hash_multiply(&a, &b);
+
+    uint64_t hash = hash_mix(a ^ HASH_SECRET0 ^ count, b ^ HASH_SECRET1);
+    return (string_hash)(hash ^ (hash >> 32));
+}
+
+RAKU_API
+void raku_json_hash_seed(uint64_t seed)
+{
+    hash_seed = seed ^ hash_mix(seed ^ HASH_SECRET0, HASH_SECRET1);
+}
+
+static void detach_view(struct json_string *string)
+{
+    if (string->_header.flags & RAKU_JSON_FLAG_VIEW)
+    {
+        raku_string_init(&string->value);
+        string->_header.flags &= ~RAKU_JSON_FLAG_VIEW;
     }
-    return hash;
+}
+
+RAKU_LOCAL
+void raku_json_string_attach(struct json_string *string, struct raku_string *value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)string, RAKU_JSON_STRING),
+           "raku_json_string_attach: invalid string.");
+    ASSERT(raku_string_chars(&string->value) == NULL,
+           "raku_json_string_attach: string must be empty.");
+
+    raku_string_own(&string->value, value);
+    string->hash = raku_json_hash(raku_string_chars(&string->value), string->value.count);
 }
 
 RAKU_API
@@ -646,9 +575,12 @@ void raku_json_string_set(struct json_string *string, struct raku_string *value)
            "raku_json_string_set: invalid string.");
     ASSERT(value != NULL,
            "raku_json_string_set: value must not be NULL!");
+    ASSERT(!(string->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_string_set: arena values are read-only.");
 
+    detach_view(string);
     raku_string_own(&string->value, value);
-    string->hash = hash_string(string->value.chars);
+    string->hash = raku_json_hash(raku_string_chars(&string->value), string->value.count);
 }
 
 RAKU_API
@@ -658,10 +590,13 @@ enum raku_status raku_json_string_setc(struct json_string *string, const char *v
            "raku_json_string_setc: invalid string.");
     ASSERT(value != NULL,
            "raku_json_string_setc: value must not be NULL!");
+    ASSERT(!(string->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_string_setc: arena values are read-only.");
 
+    detach_view(string);
     enum raku_status status = raku_string_copyc(&string->value, value);
     if (status == RAKU_OK)
-        string->hash = hash_string(string->value.chars);
+        string->hash = raku_json_hash(raku_string_chars(&string->value), string->value.count);
     
     return status;
 }
@@ -699,51 +634,225 @@ bool raku_json_string_equalc(const struct json_string *string, const char *other
     return raku_string_equalc(&string->value, other);
 }
 
-static enum raku_status grow_array(struct json_array *array, unsigned int size)
+RAKU_API
+enum raku_status raku_json_string_as_snowflake(const struct json_string *string, raku_snowflake *out)
 {
-    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
-           "grow_array: invalid array.");
+    ASSERT(raku_json_value_of_type((struct json_value*)string, RAKU_JSON_STRING),
+           "raku_json_string_as_snowflake: invalid string.");
 
-    if (size == 0)
-        return RAKU_OK;
-    else if (size > (UINT_MAX - array->count - 8))
-        return RAKU_NO_MEMORY;
-    
-    unsigned int new_capacity;
-    unsigned int min_capacity = array->count + size;
-    if (min_capacity > (UINT_MAX / 2))
-        new_capacity = min_capacity+8;
-    else
+    return raku_snowflake_parse(raku_string_chars(&string->value), string->value.count, out);
+}
+
+static void peek_scalar(const struct json_array *array, unsigned int index, union json_scalar *out)
+{
+    switch (array->kind)
     {
-        new_capacity =
-            (array->capacity < ARRAY_BASE_CAPACITY) ?
-                ARRAY_BASE_CAPACITY :
-                2 * array->capacity;
-        if (new_capacity < min_capacity)
-            new_capacity = min_capacity;
+        case RAKU_JSON_ARRAY_BOOLS:
+            raku_json_bool_init(&out->boolean);
+            out->boolean.value = array->booleans[index];
+            break;
+        case RAKU_JSON_ARRAY_INT64S:
+            raku_json_number_init(&out->number);
+            out->number.kind = RAKU_JSON_NUMBER_INT64;
+            out->number.value.integer = array->integers[index];
+            break;
+        default:
+            raku_json_number_init(&out->number);
+            out->number.value.real = array->doubles[index];
+            break;
     }
+}
 
-    enum raku_status status = raku_realloc(
-        array->values,
-        new_capacity * sizeof(struct json_value*),
-        (void**)&array->values
-    );
+RAKU_LOCAL
+struct json_value* raku_json_array_peek(const struct json_array *array, unsigned int index, union json_scalar *scratch)
+{
+    if (array->kind == RAKU_JSON_ARRAY_VALUES)
+        return array->values[index];
+    else if (array->kind == RAKU_JSON_ARRAY_BOOLS)
+        return (struct json_value*)(array->booleans[index] ? &true_node : &false_node);
 
-    if (status == RAKU_OK)
-        array->capacity = new_capacity;
-    
-    return status;
+    peek_scalar(array, index, scratch);
+    return &scratch->header;
 }
 
-RAKU_API
-enum raku_status raku_json_array_push(struct json_array *array, struct json_value *value)
+/* Turns a typed array back into an array of nodes. */
+static enum raku_status unbox_array(struct json_array *array)
 {
-    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
-           "raku_json_array_push: invalid array.");
+    if (array->kind == RAKU_JSON_ARRAY_VALUES)
+        return RAKU_OK;
 
-    enum raku_status status = RAKU_OK;
-    if (array->count+1 > array->capacity)
-    {
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "unbox_array: arena arrays are never typed.");
+
+    struct json_value **values;
+    enum raku_status status = raku_alloc_for(
+        RAKU_MEMORY_ARRAYS,
+        (size_t)array->capacity * sizeof(struct json_value*),
+        (void**)&values
+    );
+
+    if (status != RAKU_OK)
+        return status;
+
+    unsigned int created = 0;
+    for (; created < array->count; ++created)
+    {
+        if (array->kind == RAKU_JSON_ARRAY_BOOLS)
+        {
+            values[created] = (struct json_value*)(array->booleans[created] ? &true_node : &false_node);
+            continue;
+        }
+
+        union json_scalar scalar;
+        peek_scalar(array, created, &scalar);
+
+        status = raku_pool_alloc(sizeof(struct json_number), (void**)&values[created]);
+        if (status != RAKU_OK)
+            break;
+        memcpy(values[created], &scalar.number, sizeof(struct json_number));
+    }
+
+    if (status != RAKU_OK)
+    {
+        for (unsigned int i = 0; i < created; ++i)
+            raku_json_value_free(values[i]);
+        raku_free_for(RAKU_MEMORY_ARRAYS, values, (size_t)array->capacity * sizeof(struct json_value*));
+        return status;
+    }
+
+    raku_free_for(RAKU_MEMORY_ARRAYS, array->values, array_storage_size(array));
+    array->values = values;
+    array->kind = RAKU_JSON_ARRAY_VALUES;
+    return RAKU_OK;
+}
+
+static uint8_t pack_kind(struct json_value *const *values, unsigned int count)
+{
+    if (raku_json_value_of_type(values[0], RAKU_JSON_BOOL))
+    {
+        for (unsigned int i = 1; i < count; ++i)
+        {
+            if (!raku_json_value_of_type(values[i], RAKU_JSON_BOOL))
+                return RAKU_JSON_ARRAY_VALUES;
+        }
+        return RAKU_JSON_ARRAY_BOOLS;
+    }
+
+    /* Integers and reals don't mix: a double would lose the kind of the integers. */
+    uint8_t kind = RAKU_JSON_NUMBER_INT64;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!raku_json_value_of_type(values[i], RAKU_JSON_NUMBER))
+            return RAKU_JSON_ARRAY_VALUES;
+
+        const struct json_number *number = (struct json_number*)values[i];
+        if (number->kind != RAKU_JSON_NUMBER_INT64 && number->kind != RAKU_JSON_NUMBER_DOUBLE)
+            return RAKU_JSON_ARRAY_VALUES;
+        else if (i == 0)
+            kind = number->kind;
+        else if (number->kind != kind)
+            return RAKU_JSON_ARRAY_VALUES;
+    }
+
+    return (kind == RAKU_JSON_NUMBER_INT64) ? RAKU_JSON_ARRAY_INT64S : RAKU_JSON_ARRAY_DOUBLES;
+}
+
+RAKU_LOCAL
+enum raku_status raku_json_array_pack(struct json_array *array, struct json_value *const *values, unsigned int count)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_pack: invalid array.");
+    ASSERT(array->values == NULL,
+           "raku_json_array_pack: array must be empty.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_pack: arena arrays are never typed.");
+
+    uint8_t kind = (count > 0) ? pack_kind(values, count) : RAKU_JSON_ARRAY_VALUES;
+    if (kind == RAKU_JSON_ARRAY_VALUES)
+        return RAKU_OUT_OF_RANGE;
+
+    enum raku_status status = raku_alloc_for(RAKU_MEMORY_ARRAYS, count * element_size(kind), (void**)&array->values);
+    if (status != RAKU_OK)
+        return status;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const struct json_number *number = (struct json_number*)values[i];
+        switch (kind)
+        {
+            case RAKU_JSON_ARRAY_BOOLS:
+                array->booleans[i] = ((struct json_bool*)values[i])->value;
+                break;
+            case RAKU_JSON_ARRAY_INT64S:
+                array->integers[i] = number->value.integer;
+                break;
+            default:
+                array->doubles[i] = number->value.real;
+                break;
+        }
+        raku_json_value_free(values[i]);
+    }
+
+    array->kind = kind;
+    array->count = count;
+    array->capacity = count;
+    return RAKU_OK;
+}
+
+static enum raku_status grow_array(struct json_array *array, unsigned int size)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "grow_array: invalid array.");
+    ASSERT(array->kind == RAKU_JSON_ARRAY_VALUES,
+           "grow_array: typed arrays are unboxed before they grow.");
+
+    if (size == 0)
+        return RAKU_OK;
+    else if (size > (UINT_MAX - array->count - 8))
+        return RAKU_NO_MEMORY;
+    
+    unsigned int new_capacity;
+    unsigned int min_capacity = array->count + size;
+    if (min_capacity > (UINT_MAX / 2))
+        new_capacity = min_capacity+8;
+    else
+    {
+        new_capacity =
+            (array->capacity < ARRAY_BASE_CAPACITY) ?
+                ARRAY_BASE_CAPACITY :
+                2 * array->capacity;
+        if (new_capacity < min_capacity)
+            new_capacity = min_capacity;
+    }
+
+    enum raku_status status = raku_realloc_for(
+        RAKU_MEMORY_ARRAYS,
+        array->values,
+        array_storage_size(array),
+        new_capacity * sizeof(struct json_value*),
+        (void**)&array->values
+    );
+
+    if (status == RAKU_OK)
+        array->capacity = new_capacity;
+    
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_array_push(struct json_array *array, struct json_value *value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_push: invalid array.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_push: arena values are read-only.");
+
+    enum raku_status status = unbox_array(array);
+    if (status != RAKU_OK)
+        goto rjap_error;
+
+    if (array->count+1 > array->capacity)
+    {
         status = grow_array(array, 1U);
         if (status != RAKU_OK)
             goto rjap_error;
@@ -756,23 +865,73 @@ rjap_error:
 }
 
 RAKU_API
-enum raku_status raku_json_array_push_bool(struct json_array *array, bool value)
+enum raku_status raku_json_array_reserve(struct json_array *array, unsigned int capacity)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
-           "raku_json_array_push_bool: invalid array.");
+           "raku_json_array_reserve: invalid array.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_reserve: arena values are read-only.");
+
+    if (capacity <= array->capacity)
+        return RAKU_OK;
+
+    enum raku_status status = unbox_array(array);
+    if (status != RAKU_OK)
+        return status;
+
+    status = raku_realloc_for(
+        RAKU_MEMORY_ARRAYS,
+        array->values,
+        array_storage_size(array),
+        (size_t)capacity * sizeof(struct json_value*),
+        (void**)&array->values
+    );
 
-    struct json_bool *boolean;
-    enum raku_status status = raku_json_bool_create(&boolean);
     if (status == RAKU_OK)
+        array->capacity = capacity;
+
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_array_push_many(struct json_array *array, struct json_value *const *values, unsigned int count)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_push_many: invalid array.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_push_many: arena values are read-only.");
+    ASSERT(values != NULL || count == 0,
+           "raku_json_array_push_many: values must not be NULL!");
+
+    enum raku_status status = unbox_array(array);
+    if (status != RAKU_OK)
+        goto rjapm_error;
+
+    if (count > array->capacity - array->count)
     {
-        raku_json_bool_set(boolean, value);
-        status = raku_json_array_push(array, (struct json_value*)boolean);
+        status = grow_array(array, count);
         if (status != RAKU_OK)
-            raku_json_value_free((struct json_value*)boolean);
+            goto rjapm_error;
     }
+
+    if (count > 0)
+        memcpy(array->values+array->count, values, count * sizeof(struct json_value*));
+    array->count += count;
+
+rjapm_error:
     return status;
 }
 
+RAKU_API
+enum raku_status raku_json_array_push_bool(struct json_array *array, bool value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_push_bool: invalid array.");
+
+    struct json_bool *boolean = value ? &true_node : &false_node;
+    return raku_json_array_push(array, (struct json_value*)boolean);
+}
+
 RAKU_API
 enum raku_status raku_json_array_push_number(struct json_array *array, double value)
 {
@@ -846,6 +1005,10 @@ void raku_json_array_remove(struct json_array *array, struct json_value *value)
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
            "raku_json_array_remove: invalid array.");
 
+    /* Typed arrays hold no node value could point at. */
+    if (array->kind != RAKU_JSON_ARRAY_VALUES)
+        return;
+
     unsigned int index = 0;
     while (index < array->count)
     {
@@ -862,10 +1025,11 @@ void raku_json_array_remove_bool(struct json_array *array, bool value)
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
            "raku_json_array_remove_bool: invalid array.");
 
+    union json_scalar scratch;
     unsigned int index = 0;
     while (index < array->count)
     {
-        struct json_value *v = array->values[index];
+        struct json_value *v = raku_json_array_peek(array, index, &scratch);
         if (raku_json_value_of_type(v, RAKU_JSON_BOOL) &&
             raku_json_bool_get((struct json_bool*)v) == value)
         {
@@ -882,10 +1046,11 @@ void raku_json_array_remove_number(struct json_array *array, double value)
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
            "raku_json_array_remove_number: invalid array.");
 
+    union json_scalar scratch;
     unsigned int index = 0;
-    while (index  < array->count)
+    while (index < array->count)
     {
-        struct json_value *v = array->values[index];
+        struct json_value *v = raku_json_array_peek(array, index, &scratch);
         if (raku_json_value_of_type(v, RAKU_JSON_NUMBER) &&
             raku_json_number_get((struct json_number*)v) == value)
         {
@@ -904,6 +1069,9 @@ void raku_json_array_remove_string(struct json_array *array, const struct raku_s
     ASSERT(value != NULL,
            "raku_json_array_remove_string: invalid value.");
 
+    if (array->kind != RAKU_JSON_ARRAY_VALUES)
+        return;
+
     unsigned int index = 0;
     while (index < array->count)
     {
@@ -913,6 +1081,7 @@ void raku_json_array_remove_string(struct json_array *array, const struct raku_s
         {
             break;
         }
+        ++index;
     }
     raku_json_array_remove_at(array, index);
 }
@@ -925,6 +1094,9 @@ void raku_json_array_remove_stringc(struct json_array *array, const char *value)
     ASSERT(value != NULL,
            "raku_json_array_remove_stringc: invalid value.");
 
+    if (array->kind != RAKU_JSON_ARRAY_VALUES)
+        return;
+
     unsigned int index = 0;
     while (index < array->count)
     {
@@ -934,6 +1106,7 @@ void raku_json_array_remove_stringc(struct json_array *array, const char *value)
         {
             break;
         }
+        ++index;
     }
     raku_json_array_remove_at(array, index);
 }
@@ -943,220 +1116,773 @@ enum raku_status raku_json_array_remove_at(struct json_array *array, unsigned in
 {
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
            "raku_json_array_remove_at: invalid array.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_remove_at: arena values are read-only.");
 
     if (index >= array->count)
         return RAKU_OUT_OF_RANGE;
     
-    raku_json_value_free(array->values[index]);
+    size_t size = element_size(array->kind);
+    char *elements = (char*)array->values;
+    if (array->kind == RAKU_JSON_ARRAY_VALUES)
+        raku_json_value_free(array->values[index]);
+
     --array->count;
-    for (unsigned int i = index; i < array->count; ++i)
-    {
-        array->values[i] = array->values[i+1];
-    }
+    memmove(
+        elements + (index * size),
+        elements + ((index+1) * size),
+        (array->count - index) * size
+    );
     return RAKU_OK;
 }
 
 RAKU_API
-enum raku_status raku_json_array_get(struct json_array *array, unsigned int index, struct json_value **out)
+enum raku_status raku_json_array_swap_remove(struct json_array *array, unsigned int index)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
-           "raku_json_array_get: invalid array.");
+           "raku_json_array_swap_remove: invalid array.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_swap_remove: arena values are read-only.");
 
     if (index >= array->count)
         return RAKU_OUT_OF_RANGE;
-    
-    *out = array->values[index];
-    return RAKU_OK;
-}
 
-RAKU_API
-struct json_value* const* raku_json_array_values(struct json_array *array)
-{
-    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
-           "raku_json_array_values: invalid array.");
-    return array->values;
+    size_t size = element_size(array->kind);
+    char *elements = (char*)array->values;
+    if (array->kind == RAKU_JSON_ARRAY_VALUES)
+        raku_json_value_free(array->values[index]);
+
+    --array->count;
+    memcpy(elements + (index * size), elements + (array->count * size), size);
+    return RAKU_OK;
 }
 
 RAKU_API
-unsigned int raku_json_array_size(struct json_array *array)
+unsigned int raku_json_array_remove_if(
+    struct json_array *array,
+    bool (*predicate)(struct json_value *value, void *context),
+    void *context)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
-           "raku_json_array_size: invalid array.");
-    return array->count;
-}
-
-static enum raku_status grow_object(struct json_object *object)
-{
-    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "grow_object: invalid object.");
-
-    unsigned int new_capacity;
-    if (object->capacity == UINT_MAX)
-        return RAKU_NO_MEMORY;
-    else if (object->capacity > (UINT_MAX / 2))
-        new_capacity = UINT_MAX;
-    else
-    {
-        new_capacity =
-            (object->capacity < OBJECT_BASE_CAPACITY) ?
-                OBJECT_BASE_CAPACITY :
-                2 * object->capacity;
-    }
-    
-    struct json_string *keys = NULL;
-    struct json_value **values = NULL;
+           "raku_json_array_remove_if: invalid array.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_remove_if: arena values are read-only.");
+    ASSERT(predicate != NULL,
+           "raku_json_array_remove_if: predicate must not be NULL!");
 
-    enum raku_status status = raku_alloc(
-        new_capacity * sizeof(struct json_string),
-        (void**)&keys
-    );
+    size_t size = element_size(array->kind);
+    char *elements = (char*)array->values;
 
-    if (status == RAKU_OK)
+    union json_scalar scratch;
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < array->count; ++i)
     {
-        status = raku_alloc(
-            new_capacity * sizeof(struct json_value*),
-            (void**)&values
-        );
-
-        if (status == RAKU_OK)
+        struct json_value *value = raku_json_array_peek(array, i, &scratch);
+        if (predicate(value, context))
         {
-            raku_zero_memory(keys, new_capacity * sizeof(struct json_string));
-            raku_zero_memory(values, new_capacity * sizeof(struct json_value*));
-
-            unsigned int count = 0;
-            for (unsigned int i = 0;
-                 i < object->capacity && count != object->count;
-                 ++i)
-            {
-                struct json_string key = object->keys[i];
-                if (key.value.chars == NULL)
-                    continue;
-                
-                unsigned int index = key.hash % new_capacity;
-                while (true)
-                {
-                    if (keys[index].value.chars == NULL)
-                    {
-                        keys[index] = key;
-                        values[index] = object->values[i];
-                        break;
-                    }
-
-                    ++index;
-                    index = (index < new_capacity) ? index : index % new_capacity;
-                }
-                ++count;
-            }
-
-            raku_free(object->keys);
-            raku_free(object->values);
-
-            object->keys = keys;
-            object->values = values;
-            object->count = count;
-            object->capacity = new_capacity;
+            if (array->kind == RAKU_JSON_ARRAY_VALUES)
+                raku_json_value_free(value);
         }
-
         else
         {
-            raku_free(keys);
+            if (kept != i)
+                memcpy(elements + (kept * size), elements + (i * size), size);
+            ++kept;
         }
     }
 
-    return status;
+    unsigned int removed = array->count - kept;
+    array->count = kept;
+    return removed;
 }
 
 RAKU_API
-enum raku_status raku_json_object_set(struct json_object *object, const char *key, struct json_value *value)
+void raku_json_array_truncate(struct json_array *array, unsigned int count)
 {
-    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "raku_json_object_set: invalid object.");
-    ASSERT(strnlen(key, UINT_MAX) != 0, "raku_json_object_set: invalid key.");
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_truncate: invalid array.");
+    ASSERT(!(array->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_array_truncate: arena values are read-only.");
 
-    enum raku_status status = RAKU_OK;
-    if (object->count+1 > object->capacity * OBJECT_THRESHOLD)
+    if (array->kind == RAKU_JSON_ARRAY_VALUES)
     {
-        status = grow_object(object);
-        if (status != RAKU_OK)
-            goto rjos_error;
+        for (unsigned int i = count; i < array->count; ++i)
+            raku_json_value_free(array->values[i]);
     }
 
-    struct json_string jskey;
-    raku_json_string_init(&jskey);
-    status = raku_json_string_setc(&jskey, key);
-    if (status != RAKU_OK)
-        goto rjos_error;
-    
-    unsigned int index = jskey.hash % object->capacity;
-    while (true)
-    {
-        if (object->keys[index].value.chars == NULL)
-        {
-            object->keys[index] = jskey;
-            object->values[index] = value;
-            ++object->count;
-            break;
-        }
+    if (count < array->count)
+        array->count = count;
+}
 
-        else if (raku_json_string_equal(object->keys+index, &jskey))
-        {
-            raku_json_value_free(object->values[index]);
-            object->values[index] = value;
-            raku_json_string_free(&jskey);
-            break;
-        }
+RAKU_API
+enum raku_status raku_json_array_get(struct json_array *array, unsigned int index, struct json_value **out)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_get: invalid array.");
 
-        ++index;
-        index = (index < object->capacity) ? index : index % object->capacity;
+    if (index >= array->count)
+        return RAKU_OUT_OF_RANGE;
+
+    /* Bools come out as the shared true and false nodes, which can't be set anyway. */
+    if (array->kind == RAKU_JSON_ARRAY_BOOLS)
+    {
+        *out = (struct json_value*)(array->booleans[index] ? &true_node : &false_node);
+        return RAKU_OK;
     }
 
-rjos_error:
-    return status;
+    enum raku_status status = unbox_array(array);
+    if (status != RAKU_OK)
+        return status;
+
+    *out = array->values[index];
+    return RAKU_OK;
+}
+
+/* Reads the element at index into scratch when it is of type. */
+static enum raku_status peek_element(
+    const struct json_array *array,
+    unsigned int index,
+    enum json_value_type type,
+    union json_scalar *scratch,
+    struct json_value **out)
+{
+    if (index >= array->count)
+        return RAKU_OUT_OF_RANGE;
+
+    struct json_value *value = raku_json_array_peek(array, index, scratch);
+    if (raku_json_value_get_type(value) != type)
+        return RAKU_OUT_OF_RANGE;
+
+    *out = value;
+    return RAKU_OK;
 }
 
 RAKU_API
-enum raku_status raku_json_object_set_bool(struct json_object *object, const char *key, bool value)
+enum raku_status raku_json_array_get_bool(const struct json_array *array, unsigned int index, bool *out)
 {
-    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "raku_json_object_set_bool: invalid object.");
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_get_bool: invalid array.");
+    ASSERT(out != NULL,
+           "raku_json_array_get_bool: out must not be NULL!");
 
-    struct json_bool *boolean;
-    enum raku_status status = raku_json_bool_create(&boolean);
+    union json_scalar scratch;
+    struct json_value *value;
+    enum raku_status status = peek_element(array, index, RAKU_JSON_BOOL, &scratch, &value);
     if (status == RAKU_OK)
-    {
-        raku_json_bool_set(boolean, value);
-        status = raku_json_object_set(object, key, (struct json_value*)boolean);
-        if (status != RAKU_OK)
-            raku_json_value_free((struct json_value*)boolean);
-    }
+        *out = ((struct json_bool*)value)->value;
     return status;
 }
 
 RAKU_API
-enum raku_status raku_json_object_set_number(struct json_object *object, const char *key, double value)
+enum raku_status raku_json_array_get_number(const struct json_array *array, unsigned int index, double *out)
 {
-    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "raku_json_object_set_number: invalid object.");
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_get_number: invalid array.");
+    ASSERT(out != NULL,
+           "raku_json_array_get_number: out must not be NULL!");
 
-    struct json_number *number;
-    enum raku_status status = raku_json_number_create(&number);
+    union json_scalar scratch;
+    struct json_value *value;
+    enum raku_status status = peek_element(array, index, RAKU_JSON_NUMBER, &scratch, &value);
     if (status == RAKU_OK)
-    {
-        raku_json_number_set(number, value);
-        status = raku_json_object_set(object, key, (struct json_value*)number);
-        if (status != RAKU_OK)
-            raku_json_value_free((struct json_value*)number);
-    }
+        *out = raku_json_number_get((struct json_number*)value);
     return status;
 }
 
 RAKU_API
-enum raku_status raku_json_object_set_string(struct json_object *object, const char *key, struct raku_string *value)
+enum raku_status raku_json_array_get_int64(const struct json_array *array, unsigned int index, int64_t *out)
 {
-    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "raku_json_object_set_string: invalid object.");
-    ASSERT(value != NULL,
-           "raku_json_object_set_string: invalid value.");
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_get_int64: invalid array.");
+    ASSERT(out != NULL,
+           "raku_json_array_get_int64: out must not be NULL!");
+
+    union json_scalar scratch;
+    struct json_value *value;
+    enum raku_status status = peek_element(array, index, RAKU_JSON_NUMBER, &scratch, &value);
+    if (status == RAKU_OK)
+        status = raku_json_number_get_int64((struct json_number*)value, out);
+    return status;
+}
+
+RAKU_API
+struct json_value* const* raku_json_array_values(struct json_array *array)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_values: invalid array.");
+
+    if (unbox_array(array) != RAKU_OK)
+        return NULL;
+    return array->values;
+}
+
+static enum raku_status array_span(struct json_array *array, uint8_t kind, const void **out)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "array_span: invalid array.");
+    ASSERT(out != NULL,
+           "array_span: out must not be NULL!");
+
+    if (array->count == 0)
+        *out = NULL;
+    else if (array->kind == kind)
+        *out = array->values;
+    else
+        return RAKU_OUT_OF_RANGE;
+
+    return RAKU_OK;
+}
+
+RAKU_API
+enum raku_status raku_json_array_as_doubles(struct json_array *array, const double **out)
+{
+    return array_span(array, RAKU_JSON_ARRAY_DOUBLES, (const void**)out);
+}
+
+RAKU_API
+enum raku_status raku_json_array_as_int64s(struct json_array *array, const int64_t **out)
+{
+    return array_span(array, RAKU_JSON_ARRAY_INT64S, (const void**)out);
+}
+
+RAKU_API
+enum raku_status raku_json_array_as_bools(struct json_array *array, const bool **out)
+{
+    return array_span(array, RAKU_JSON_ARRAY_BOOLS, (const void**)out);
+}
+
+
+RAKU_API
+unsigned int raku_json_array_size(struct json_array *array)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)array, RAKU_JSON_ARRAY),
+           "raku_json_array_size: invalid array.");
+    return array->count;
+}
+
+static inline unsigned int lowest_bit(uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned int)index;
+#else
+    return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+static inline uint32_t group_match(const uint8_t *group, uint8_t control)
+{
+#if defined(OBJECT_SSE2)
+    __m128i bytes = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)control)));
+#else
+    uint32_t mask = 0;
+    for (unsigned int i = 0; i < OBJECT_GROUP_SIZE; ++i)
+        mask |= (uint32_t)(group[i] == control) << i;
+    return mask;
+#endif
+}
+
+static inline uint32_t group_match_empty(const uint8_t *group)
+{
+    return group_match(group, CONTROL_EMPTY);
+}
+
+/* Matches the empty and the deleted buckets, which both have the high bit set. */
+static inline uint32_t group_match_free(const uint8_t *group)
+{
+#if defined(OBJECT_SSE2)
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    uint32_t mask = 0;
+    for (unsigned int i = 0; i < OBJECT_GROUP_SIZE; ++i)
+        mask |= (uint32_t)(group[i] >> 7) << i;
+    return mask;
+#endif
+}
+
+static inline uint32_t small_match(const uint32_t *hashes, string_hash hash)
+{
+#if defined(OBJECT_SSE2)
+    __m128i needle = _mm_set1_epi32((int)hash);
+    __m128i low = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)hashes), needle);
+    __m128i high = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(hashes+4)), needle);
+    return
+        (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(low)) |
+        ((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(high)) << 4);
+#else
+    uint32_t mask = 0;
+    for (unsigned int i = 0; i < OBJECT_SMALL_CAPACITY; ++i)
+        mask |= (uint32_t)(hashes[i] == hash) << i;
+    return mask;
+#endif
+}
+
+/* The member index of every bucket or, for small objects, the hash of every member. */
+static inline uint32_t* object_slots(const struct json_object *object)
+{
+    return (uint32_t*)(object->members + object->capacity);
+}
+
+static inline uint8_t* object_control(const struct json_object *object)
+{
+    return (uint8_t*)(object_slots(object) + object->mask + 1);
+}
+
+/* Tables are kept at most 7/8 full. */
+static inline unsigned int bucket_capacity(unsigned int buckets)
+{
+    return buckets - (buckets / 8);
+}
+
+static inline bool is_small(const struct json_object *object)
+{
+    return object->mask == 0;
+}
+
+static inline unsigned int first_group(const struct json_object *object, string_hash hash)
+{
+    return (hash >> 7) & object->mask & ~(unsigned int)(OBJECT_GROUP_SIZE - 1);
+}
+
+static bool find_member(
+    const struct json_object *object,
+    const char *key,
+    unsigned int count,
+    string_hash hash,
+    unsigned int *out)
+{
+    if (object->count == 0)
+        return false;
+
+    const uint32_t *slots = object_slots(object);
+    if (is_small(object))
+    {
+        uint32_t match = small_match(slots, hash) & ((1U << object->count) - 1);
+        while (match != 0)
+        {
+            unsigned int index = lowest_bit(match);
+            const struct json_atom *candidate = object->members[index].key;
+            if (candidate->count == count &&
+                (candidate->chars == key || memcmp(candidate->chars, key, count) == 0))
+            {
+                *out = index;
+                return true;
+            }
+            match &= match - 1;
+        }
+        return false;
+    }
+
+    const uint8_t *control = object_control(object);
+
+    unsigned int group = first_group(object, hash);
+    for (unsigned int step = OBJECT_GROUP_SIZE; ; step += OBJECT_GROUP_SIZE)
+    {
+        uint32_t match = group_match(control+group, (uint8_t)(hash & 0x7F));
+        while (match != 0)
+        {
+            unsigned int index = slots[group + lowest_bit(match)];
+            const struct json_atom *candidate = object->members[index].key;
+            if (candidate->count == count &&
+                (candidate->chars == key ||
+                 (candidate->hash == hash && memcmp(candidate->chars, key, count) == 0)))
+            {
+                *out = index;
+                return true;
+            }
+            match &= match - 1;
+        }
+
+        if (group_match_empty(control+group) != 0)
+            return false;
+
+        /* Triangular steps visit every group of a power-of-two table. */
+        group = (group + step) & object->mask;
+    }
+}
+
+static void index_member(struct json_object *object, unsigned int index)
+{
+    uint32_t *slots = object_slots(object);
+    string_hash hash = object->members[index].key->hash;
+    if (is_small(object))
+    {
+        slots[index] = hash;
+        return;
+    }
+
+    uint8_t *control = object_control(object);
+    unsigned int group = first_group(object, hash);
+    for (unsigned int step = OBJECT_GROUP_SIZE; ; step += OBJECT_GROUP_SIZE)
+    {
+        uint32_t available = group_match_free(control+group);
+        if (available != 0)
+        {
+            unsigned int slot = group + lowest_bit(available);
+            control[slot] = (uint8_t)(hash & 0x7F);
+            slots[slot] = index;
+            return;
+        }
+
+        group = (group + step) & object->mask;
+    }
+}
+
+/*
+ * Drops the bucket of the member at index. Lookups stop at the first group
+ * with an empty bucket, so when the group already has one no probe goes
+ * past it and the bucket can be emptied, otherwise it is marked deleted.
+ * Every deleted bucket stands for a hole, so holes and live members never
+ * fill more than 7/8 of the buckets and probes always end.
+ */
+static void unindex_member(struct json_object *object, unsigned int index)
+{
+    const uint32_t *slots = object_slots(object);
+    uint8_t *control = object_control(object);
+    string_hash hash = object->members[index].key->hash;
+
+    unsigned int group = first_group(object, hash);
+    for (unsigned int step = OBJECT_GROUP_SIZE; ; step += OBJECT_GROUP_SIZE)
+    {
+        uint32_t match = group_match(control+group, (uint8_t)(hash & 0x7F));
+        while (match != 0)
+        {
+            unsigned int slot = group + lowest_bit(match);
+            if (slots[slot] == index)
+            {
+                control[slot] = (group_match_empty(control+group) != 0) ? CONTROL_EMPTY : CONTROL_DELETED;
+                return;
+            }
+            match &= match - 1;
+        }
+
+        group = (group + step) & object->mask;
+    }
+}
+
+/* Moves the members of object down over its holes, then indexes them again. */
+static void rebuild_index(struct json_object *object)
+{
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < object->used; ++i)
+    {
+        if (object->members[i].key != NULL)
+            object->members[count++] = object->members[i];
+    }
+    object->used = count;
+
+    if (!is_small(object))
+        memset(object_control(object), CONTROL_EMPTY, object->mask + 1);
+    for (unsigned int i = 0; i < count; ++i)
+        index_member(object, i);
+}
+
+RAKU_LOCAL
+unsigned int raku_json_object_buckets_for(unsigned int count)
+{
+    if (count <= OBJECT_SMALL_CAPACITY)
+        return 0;
+
+    unsigned int buckets = OBJECT_MIN_BUCKETS;
+    while (bucket_capacity(buckets) < count && buckets <= (UINT_MAX / 4))
+    {
+        buckets *= 2;
+    }
+    return buckets;
+}
+
+RAKU_LOCAL
+size_t raku_json_object_storage_size(unsigned int capacity, unsigned int buckets)
+{
+    if (buckets == 0)
+    {
+        return
+            ((size_t)capacity * sizeof(struct json_member)) +
+            (OBJECT_SMALL_CAPACITY * sizeof(uint32_t));
+    }
+
+    return
+        ((size_t)capacity * sizeof(struct json_member)) +
+        ((size_t)buckets * sizeof(uint32_t)) +
+        (size_t)buckets;
+}
+
+RAKU_LOCAL
+void raku_json_object_attach(struct json_object *object, void *storage, unsigned int capacity, unsigned int buckets)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_attach: invalid object.");
+    ASSERT(object->members == NULL,
+           "raku_json_object_attach: object must be empty.");
+    ASSERT(capacity <= ((buckets == 0) ? OBJECT_SMALL_CAPACITY : bucket_capacity(buckets)),
+           "raku_json_object_attach: too many members for the buckets.");
+
+    object->members = (struct json_member*)storage;
+    object->count = 0;
+    object->used = 0;
+    object->capacity = capacity;
+    object->mask = (buckets == 0) ? 0 : buckets - 1;
+    if (buckets == 0)
+        memset(object_slots(object), 0, OBJECT_SMALL_CAPACITY * sizeof(uint32_t));
+    else
+        memset(object_control(object), CONTROL_EMPTY, buckets);
+}
+
+/* Moves the members of object to a new block sized for capacity members. */
+static enum raku_status resize_object(struct json_object *object, unsigned int capacity)
+{
+    unsigned int buckets = raku_json_object_buckets_for(capacity);
+
+    struct json_member *members;
+    enum raku_status status = raku_alloc_for(
+        RAKU_MEMORY_OBJECT_TABLES,
+        raku_json_object_storage_size(capacity, buckets),
+        (void**)&members
+    );
+
+    if (status == RAKU_OK)
+    {
+        if (object->used > 0)
+            memcpy(members, object->members, object->used * sizeof(struct json_member));
+        raku_free_for(RAKU_MEMORY_OBJECT_TABLES, object->members, object_storage_size(object));
+
+        object->members = members;
+        object->capacity = capacity;
+        object->mask = (buckets == 0) ? 0 : buckets - 1;
+        if (buckets == 0)
+            memset(object_slots(object), 0, OBJECT_SMALL_CAPACITY * sizeof(uint32_t));
+        rebuild_index(object);
+    }
+
+    return status;
+}
+
+static enum raku_status grow_object(struct json_object *object)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "grow_object: invalid object.");
+
+    if (object->used == UINT_MAX)
+        return RAKU_NO_MEMORY;
+
+    /* A table with enough holes makes room by compacting in place. */
+    if (object->used - object->count > object->capacity / 8)
+    {
+        rebuild_index(object);
+        return RAKU_OK;
+    }
+
+    /* Small objects grow in place until they are promoted to a table. */
+    unsigned int buckets = raku_json_object_buckets_for(object->used + 1);
+    unsigned int capacity;
+    if (buckets == 0)
+    {
+        capacity =
+            (object->capacity < OBJECT_SMALL_BASE_CAPACITY) ?
+                OBJECT_SMALL_BASE_CAPACITY :
+                2 * object->capacity;
+        if (capacity > OBJECT_SMALL_CAPACITY)
+            capacity = OBJECT_SMALL_CAPACITY;
+    }
+    else
+        capacity = bucket_capacity(buckets);
+
+    if (capacity <= object->used)
+        return RAKU_NO_MEMORY;
+
+    return resize_object(object, capacity);
+}
+
+static void append_member(struct json_object *object, struct json_atom *key, struct json_value *value)
+{
+    object->members[object->used] = (struct json_member) {
+        .key = key,
+        .value = value
+    };
+    index_member(object, object->used++);
+    ++object->count;
+}
+
+RAKU_LOCAL
+void raku_json_object_insert(struct json_object *object, struct json_atom *key, struct json_value *value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_insert: invalid object.");
+    ASSERT(object->used < object->capacity,
+           "raku_json_object_insert: object is full.");
+
+    unsigned int index;
+    if (find_member(object, key->chars, key->count, key->hash, &index))
+    {
+        raku_json_value_free(object->members[index].value);
+        object->members[index].value = value;
+        raku_json_value_free((struct json_value*)key);
+    }
+
+    else
+        append_member(object, key, value);
+}
+
+RAKU_API
+enum raku_status raku_json_object_set(struct json_object *object, const char *key, struct json_value *value)
+{
+    ASSERT(strnlen(key, UINT_MAX) != 0, "raku_json_object_set: invalid key.");
+    return raku_json_object_set_n(object, key, strnlen(key, UINT_MAX), value);
+}
+
+RAKU_API
+enum raku_status raku_json_object_set_n(struct json_object *object, const char *key, size_t size, struct json_value *value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_set_n: invalid object.");
+    ASSERT(key != NULL && size <= UINT_MAX, "raku_json_object_set_n: invalid key.");
+    ASSERT(!(object->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_object_set_n: arena values are read-only.");
+
+    unsigned int count = (unsigned int)size;
+    string_hash hash = raku_json_hash(key, count);
+
+    unsigned int index;
+    if (find_member(object, key, count, hash, &index))
+    {
+        raku_json_value_free(object->members[index].value);
+        object->members[index].value = value;
+        return RAKU_OK;
+    }
+
+    enum raku_status status = RAKU_OK;
+    if (object->used == object->capacity)
+    {
+        status = grow_object(object);
+        if (status != RAKU_OK)
+            goto rjos_error;
+    }
+
+    struct json_atom *atom;
+    status = raku_json_atom_acquire(key, count, hash, NULL, &atom);
+    if (status != RAKU_OK)
+        goto rjos_error;
+
+    append_member(object, atom, value);
+
+rjos_error:
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_object_reserve(struct json_object *object, unsigned int capacity)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_reserve: invalid object.");
+    ASSERT(!(object->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_object_reserve: arena values are read-only.");
+
+    if (capacity <= object->capacity)
+        return RAKU_OK;
+
+    /* A table has room for as many members as its buckets allow anyway. */
+    unsigned int buckets = raku_json_object_buckets_for(capacity);
+    if (buckets != 0)
+        capacity = bucket_capacity(buckets);
+
+    return resize_object(object, capacity);
+}
+
+RAKU_API
+enum raku_status raku_json_object_create_from(const struct json_pair *pairs, unsigned int count, struct json_object **out)
+{
+    ASSERT(pairs != NULL || count == 0,
+           "raku_json_object_create_from: pairs must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_json_object_create_from: out must not be NULL!");
+
+    struct json_object *object;
+    enum raku_status status = raku_json_object_create(&object);
+    if (status != RAKU_OK)
+        goto rjocf_end1;
+
+    status = raku_json_object_reserve(object, count);
+    if (status != RAKU_OK)
+        goto rjocf_end2;
+
+    /* Every key is acquired first so that failing leaves the values to the caller. */
+    unsigned int acquired = 0;
+    for (; acquired < count; ++acquired)
+    {
+        const char *key = pairs[acquired].key;
+        ASSERT(key != NULL, "raku_json_object_create_from: invalid key.");
+
+        unsigned int size = (unsigned int)strnlen(key, UINT_MAX);
+        status = raku_json_atom_acquire(
+            key,
+            size,
+            raku_json_hash(key, size),
+            NULL,
+            &object->members[acquired].key
+        );
+
+        if (status != RAKU_OK)
+            break;
+    }
+
+    if (status != RAKU_OK)
+    {
+        for (unsigned int i = 0; i < acquired; ++i)
+            raku_json_value_free((struct json_value*)object->members[i].key);
+        goto rjocf_end2;
+    }
+
+    /* Members are compacted in place: a member only moves down, after it was read. */
+    for (unsigned int i = 0; i < count; ++i)
+        raku_json_object_insert(object, object->members[i].key, pairs[i].value);
+
+    *out = object;
+
+rjocf_end2:
+    if (status != RAKU_OK)
+        raku_json_value_free((struct json_value*)object);
+
+rjocf_end1:
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_object_set_bool(struct json_object *object, const char *key, bool value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_set_bool: invalid object.");
+
+    struct json_bool *boolean = value ? &true_node : &false_node;
+    return raku_json_object_set(object, key, (struct json_value*)boolean);
+}
+
+RAKU_API
+enum raku_status raku_json_object_set_number(struct json_object *object, const char *key, double value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_set_number: invalid object.");
+
+    struct json_number *number;
+    enum raku_status status = raku_json_number_create(&number);
+    if (status == RAKU_OK)
+    {
+        raku_json_number_set(number, value);
+        status = raku_json_object_set(object, key, (struct json_value*)number);
+        if (status != RAKU_OK)
+            raku_json_value_free((struct json_value*)number);
+    }
+    return status;
+}
+
+RAKU_API
+enum raku_status raku_json_object_set_string(struct json_object *object, const char *key, struct raku_string *value)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_set_string: invalid object.");
+    ASSERT(value != NULL,
+           "raku_json_object_set_string: invalid value.");
 
     struct json_string *string;
     enum raku_status status = raku_json_string_create(&string);
@@ -1199,117 +1925,212 @@ rjossc_end:
 
 RAKU_API
 void raku_json_object_remove(struct json_object *object, const char *key)
+{
+    ASSERT(strnlen(key, UINT_MAX) != 0, "raku_json_object_remove: invalid key.");
+    raku_json_object_remove_n(object, key, strnlen(key, UINT_MAX));
+}
+
+RAKU_API
+void raku_json_object_remove_n(struct json_object *object, const char *key, size_t size)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "raku_json_object_remove: invalid object.");
-
-    unsigned int size = (unsigned int)strnlen(key, UINT_MAX);
-    ASSERT(size != 0, "raku_json_object_remove: invalid key.");
-
-    const struct json_string jskey = {
-        ._header.type = RAKU_JSON_STRING,
-        .hash = hash_string(key),
-        .value = {
-            .chars = (char*)key,
-            .count = size,
-            .capacity = size
-        }
-    };
+           "raku_json_object_remove_n: invalid object.");
+    ASSERT(!(object->_header.flags & RAKU_JSON_FLAG_ARENA),
+           "raku_json_object_remove_n: arena values are read-only.");
+    ASSERT(key != NULL && size <= UINT_MAX, "raku_json_object_remove_n: invalid key.");
 
-    unsigned int index = jskey.hash % object->capacity;
-    while (true)
-    {
-        if (object->keys[index].value.chars == NULL)
-            return;
-        else if (raku_json_string_equal(object->keys+index, &jskey))
-            break;
-        ++index;
-        index = (index < object->capacity) ? index : index % object->capacity;
-    }
+    unsigned int count = (unsigned int)size;
+    unsigned int index;
+    if (!find_member(object, key, count, raku_json_hash(key, count), &index))
+        return;
 
-    raku_json_string_free(object->keys+index);
-    raku_json_value_free(object->values[index]);
+    struct json_member removed = object->members[index];
     --object->count;
 
-    for (unsigned int i = index+1; object->keys[i].value.chars != NULL; ++i)
+    if (is_small(object))
     {
-        i = (i < object->capacity) ? i : i % object->capacity;
+        uint32_t *hashes = object_slots(object);
+        --object->used;
+        memmove(
+            object->members+index,
+            object->members+index+1,
+            (object->used - index) * sizeof(struct json_member)
+        );
+        memmove(hashes+index, hashes+index+1, (object->used - index) * sizeof(uint32_t));
+    }
 
-        struct json_string key = object->keys[i];
-        if ((key.hash % object->capacity) <= index)
-        {
-            object->keys[index] = key;
-            object->values[index] = object->values[i];
-            index = i;
-        }
+    else
+    {
+        unindex_member(object, index);
+        object->members[index] = (struct json_member) {
+            .key = NULL,
+            .value = NULL
+        };
     }
 
-    raku_json_string_init(object->keys+index);
-    object->values[index] = NULL;
+    raku_json_value_free((struct json_value*)removed.key);
+    raku_json_value_free(removed.value);
 }
 
 RAKU_API
 bool raku_json_object_has(struct json_object *object, const char *key)
 {
-    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "raku_json_object_has: invalid object.");
-
-    unsigned int size = (unsigned int)strnlen(key, UINT_MAX);
-    ASSERT(size != 0, "raku_json_object_has: invalid key.");
-
-    const struct json_string jskey = {
-        ._header.type = RAKU_JSON_STRING,
-        .hash = hash_string(key),
-        .value = {
-            .chars = (char*)key,
-            .count = size,
-            .capacity = size
-        }
+    ASSERT(strnlen(key, UINT_MAX) != 0, "raku_json_object_has: invalid key.");
+    return raku_json_object_has_n(object, key, strnlen(key, UINT_MAX));
+}
+
+RAKU_API
+bool raku_json_object_has_n(struct json_object *object, const char *key, size_t size)
+{
+    struct json_key hashed = raku_json_key_make(key, size);
+    return raku_json_object_has_key(object, &hashed);
+}
+
+RAKU_API
+enum raku_status raku_json_object_get(struct json_object *object, const char *key, struct json_value **out)
+{
+    ASSERT(strnlen(key, UINT_MAX) != 0, "raku_json_object_get: invalid key.");
+    return raku_json_object_get_n(object, key, strnlen(key, UINT_MAX), out);
+}
+
+RAKU_API
+enum raku_status raku_json_object_get_n(struct json_object *object, const char *key, size_t size, struct json_value **out)
+{
+    struct json_key hashed = raku_json_key_make(key, size);
+    return raku_json_object_get_key(object, &hashed, out);
+}
+
+RAKU_API
+struct json_key raku_json_key_make(const char *key, size_t size)
+{
+    ASSERT(key != NULL && size <= UINT_MAX,
+           "raku_json_key_make: invalid key.");
+
+    return (struct json_key) {
+        .chars = key,
+        .count = (unsigned int)size,
+        .hash = raku_json_hash(key, (unsigned int)size)
     };
+}
+
+RAKU_API
+bool raku_json_object_has_key(struct json_object *object, const struct json_key *key)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_has_key: invalid object.");
+    ASSERT(key != NULL, "raku_json_object_has_key: invalid key.");
+
+    unsigned int index;
+    return find_member(object, key->chars, key->count, key->hash, &index);
+}
+
+RAKU_API
+enum raku_status raku_json_object_get_key(struct json_object *object, const struct json_key *key, struct json_value **out)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_get_key: invalid object.");
+    ASSERT(key != NULL, "raku_json_object_get_key: invalid key.");
+
+    unsigned int index;
+    if (!find_member(object, key->chars, key->count, key->hash, &index))
+        return RAKU_OUT_OF_RANGE;
 
-    unsigned int index = jskey.hash % object->capacity;
-    while (true)
+    *out = object->members[index].value;
+    return RAKU_OK;
+}
+
+RAKU_API
+enum raku_status raku_json_object_get_snowflake(struct json_object *object, const char *key, raku_snowflake *out)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_get_snowflake: invalid object.");
+
+    struct json_value *value;
+    enum raku_status status = raku_json_object_get(object, key, &value);
+    if (status != RAKU_OK)
+        return status;
+
+    switch (raku_json_value_get_type(value))
     {
-        if (object->keys[index].value.chars == NULL)
-            return false;
-        else if (raku_json_string_equal(object->keys+index, &jskey))
-            return true;
-        ++index;
-        index = (index < object->capacity) ? index : index % object->capacity;
+        case RAKU_JSON_STRING:
+            return raku_json_string_as_snowflake((struct json_string*)value, out);
+        case RAKU_JSON_NUMBER:
+            if (raku_json_number_get_uint64((struct json_number*)value, out) == RAKU_OK)
+                return RAKU_OK;
+            /* fallthrough */
+        default:
+            return RAKU_JSON_INVALID_SNOWFLAKE;
     }
 }
 
 RAKU_API
-enum raku_status raku_json_object_get(struct json_object *object, const char *key, struct json_value **out)
+bool raku_json_object_has_atom(struct json_object *object, const struct json_atom *key)
 {
     ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
-           "raku_json_object_get: invalid object.");
-
-    unsigned int size = (unsigned int)strnlen(key, UINT_MAX);
-    ASSERT(size != 0, "raku_json_object_get: invalid key.");
-
-    const struct json_string jskey = {
-        ._header.type = RAKU_JSON_STRING,
-        .hash = hash_string(key),
-        .value = {
-            .chars = (char*)key,
-            .count = size,
-            .capacity = size
-        }
+           "raku_json_object_has_atom: invalid object.");
+    ASSERT(key != NULL, "raku_json_object_has_atom: invalid key.");
+
+    unsigned int index;
+    return find_member(object, key->chars, key->count, key->hash, &index);
+}
+
+RAKU_API
+enum raku_status raku_json_object_get_atom(struct json_object *object, const struct json_atom *key, struct json_value **out)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_get_atom: invalid object.");
+    ASSERT(key != NULL, "raku_json_object_get_atom: invalid key.");
+
+    unsigned int index;
+    if (!find_member(object, key->chars, key->count, key->hash, &index))
+        return RAKU_OUT_OF_RANGE;
+
+    *out = object->members[index].value;
+    return RAKU_OK;
+}
+
+RAKU_API
+unsigned int raku_json_object_size(struct json_object *object)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_size: invalid object.");
+    return object->count;
+}
+
+RAKU_API
+void raku_json_object_iter_begin(struct json_object *object, struct json_object_iter *iter)
+{
+    ASSERT(raku_json_value_of_type((struct json_value*)object, RAKU_JSON_OBJECT),
+           "raku_json_object_iter_begin: invalid object.");
+    ASSERT(iter != NULL,
+           "raku_json_object_iter_begin: iter must not be NULL!");
+
+    *iter = (struct json_object_iter) {
+        .object = object,
+        .index = 0,
+        .key = NULL,
+        .size = 0,
+        .value = NULL
     };
+}
 
-    unsigned int index = jskey.hash % object->capacity;
-    while (true)
+RAKU_API
+bool raku_json_object_iter_next(struct json_object_iter *iter)
+{
+    ASSERT(iter != NULL && iter->object != NULL,
+           "raku_json_object_iter_next: invalid iterator.");
+
+    const struct json_member *member;
+    do
     {
-        if (object->keys[index].value.chars == NULL)
-            return RAKU_OUT_OF_RANGE;
-        else if (raku_json_string_equal(object->keys+index, &jskey))
-        {
-            *out = object->values[index];
-            return RAKU_OK;
-        }
-        
-        ++index;
-        index = (index < object->capacity) ? index : index % object->capacity;
-    }
+        if (iter->index >= iter->object->used)
+            return false;
+
+        member = &iter->object->members[iter->index++];
+    } while (member->key == NULL);
+
+    iter->key = member->key->chars;
+    iter->size = member->key->count;
+    iter->value = member->value;
+    return true;
 }
\ No newline at end of file
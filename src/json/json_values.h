@@ -5,9 +5,25 @@
 
 typedef uint32_t string_hash;
 
+/* Internal value type of object keys, see json_atoms.h. */
+#define RAKU_JSON_KEY (RAKU_JSON_OBJECT + 1)
+
+enum json_value_flag
+{
+    RAKU_JSON_FLAG_ARENA = 1 << 0,
+    RAKU_JSON_FLAG_VIEW  = 1 << 1,
+
+    /* The key lives in the shared atom table and is never freed. */
+    RAKU_JSON_FLAG_INTERNED = 1 << 2,
+
+    /* One of the immutable null, true and false nodes, see raku_json_null(). */
+    RAKU_JSON_FLAG_SHARED = 1 << 3
+};
+
 struct json_value
 {
-    enum json_value_type type;
+    uint8_t type;
+    uint8_t flags;
 };
 
 struct json_bool
@@ -16,10 +32,23 @@ struct json_bool
     bool value;
 };
 
+enum json_number_kind
+{
+    RAKU_JSON_NUMBER_DOUBLE,
+    RAKU_JSON_NUMBER_INT64,
+    RAKU_JSON_NUMBER_UINT64
+};
+
 struct json_number
 {
     struct json_value _header;
-    double value;
+    uint8_t kind;
+    union
+    {
+        double real;
+        int64_t integer;
+        uint64_t unsigned_integer;
+    } value;
 };
 
 struct json_string
@@ -29,21 +58,69 @@ struct json_string
     struct raku_string value;
 };
 
+enum json_array_kind
+{
+    RAKU_JSON_ARRAY_VALUES,
+    RAKU_JSON_ARRAY_DOUBLES,
+    RAKU_JSON_ARRAY_INT64S,
+    RAKU_JSON_ARRAY_BOOLS
+};
+
+/*
+ * Arrays of a kind other than RAKU_JSON_ARRAY_VALUES hold their elements
+ * unboxed. Accessors that hand out or take nodes turn them back into a
+ * values array first.
+ */
 struct json_array
 {
     struct json_value _header;
-    struct json_value **values;
+    uint8_t kind;
+    union
+    {
+        struct json_value **values;
+        double *doubles;
+        int64_t *integers;
+        bool *booleans;
+    };
     unsigned int count;
     unsigned int capacity;
 };
 
+/* Room for one element of a typed array, see raku_json_array_peek(). */
+union json_scalar
+{
+    struct json_value header;
+    struct json_bool boolean;
+    struct json_number number;
+};
+
+struct json_member
+{
+    struct json_atom *key;
+    struct json_value *value;
+};
+
+/*
+ * The first used members are kept in insertion order. Tables with buckets
+ * (mask+1 of them, a power of two) index them Swiss-table style: the
+ * storage block holds capacity members, then one member index per bucket,
+ * then one control byte per bucket, either empty, deleted (both with the
+ * high bit set) or the low 7 bits of the key's hash. Buckets are probed 16
+ * control bytes at a time. Removing a member from a table leaves a hole, a
+ * member with a NULL key, until the table is compacted or resized.
+ *
+ * Small objects (mask 0, at most 8 members) have no buckets and no holes.
+ * The members are followed by an array of their 8 hashes, compared all at
+ * once.
+ */
 struct json_object
 {
     struct json_value _header;
-    struct json_string *keys;
-    struct json_value **values;
+    struct json_member *members;
     unsigned int count;
+    unsigned int used;
     unsigned int capacity;
+    unsigned int mask;
 };
 
 RAKU_LOCAL
@@ -61,6 +138,51 @@ void raku_json_array_init(struct json_array *array);
 RAKU_LOCAL
 void raku_json_object_init(struct json_object *object);
 
+/* Returns the size of a node of type, 0 for an invalid type. */
+RAKU_LOCAL
+size_t raku_json_node_size(enum json_value_type type);
+
+RAKU_LOCAL
+string_hash raku_json_hash(const char *chars, unsigned int count);
+
+RAKU_LOCAL
+void raku_json_string_attach(struct json_string *string, struct raku_string *value);
+
+/*
+ * Stores the count values into the empty array unboxed, freeing them, when
+ * they are all bools, all integer numbers, or all numbers a double holds
+ * exactly. Returns RAKU_OUT_OF_RANGE and leaves values untouched otherwise.
+ */
+RAKU_LOCAL
+enum raku_status raku_json_array_pack(struct json_array *array, struct json_value *const *values, unsigned int count);
+
+/* Returns the element at index, built into scratch when array is typed. */
+RAKU_LOCAL
+struct json_value* raku_json_array_peek(const struct json_array *array, unsigned int index, union json_scalar *scratch);
+
+/*
+ * Returns the count of buckets an object holding count members is built
+ * with, 0 for a small object.
+ */
+RAKU_LOCAL
+unsigned int raku_json_object_buckets_for(unsigned int count);
+
+/* Returns the size of the storage block for capacity members and buckets. */
+RAKU_LOCAL
+size_t raku_json_object_storage_size(unsigned int capacity, unsigned int buckets);
+
+/* Makes storage the empty table of object, which must have none. */
+RAKU_LOCAL
+void raku_json_object_attach(struct json_object *object, void *storage, unsigned int capacity, unsigned int buckets);
+
+/*
+ * Moves key into object, or releases it when object already holds the key,
+ * in which case the previous value is freed and replaced. object must have
+ * room for one more member.
+ */
+RAKU_LOCAL
+void raku_json_object_insert(struct json_object *object, struct json_atom *key, struct json_value *value);
+
 RAKU_LOCAL
 void raku_json_string_free(struct json_string *string);
 
@@ -0,0 +1,329 @@
+#include <RAKU/json.h>
+#include "json_values.h"
+#include "json_atoms.h"
+#include "json_number.h"
+#include <RAKU/debug.h>
+
+#include <limits.h>
+#include <string.h>
+
+struct json_writer
+{
+    const char *indent;
+    size_t indent_size;
+};
+
+/* Serialized size of every byte inside a string: 1 verbatim, 2 short escape, 6 \u00XX. */
+static const uint8_t escape_sizes[256] = {
+    6, 6, 6, 6, 6, 6, 6, 6, 2, 2, 2, 6, 2, 2, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static void json_writer_init(struct json_writer *writer, enum json_format_option options)
+{
+    switch (options & 0x3)
+    {
+        case RAKU_JSON_FORMAT_INDENT2:
+            writer->indent = "  ";
+            break;
+        case RAKU_JSON_FORMAT_INDENT4:
+            writer->indent = "    ";
+            break;
+        case RAKU_JSON_FORMAT_TAB:
+            writer->indent = "\t";
+            break;
+        default:
+            writer->indent = "";
+            break;
+    }
+
+    writer->indent_size = strlen(writer->indent);
+}
+
+static size_t measure_string(const char *chars, unsigned int count)
+{
+    const unsigned char *c = (const unsigned char*)chars;
+    const unsigned char *end = c + count;
+
+    size_t size = 2;
+    for (; c != end; ++c)
+        size += escape_sizes[*c];
+    return size;
+}
+
+static size_t measure_value(const struct json_writer *writer, struct json_value *value, size_t level)
+{
+    switch (raku_json_value_get_type(value))
+    {
+        case RAKU_JSON_BOOL:
+            return ((struct json_bool*)value)->value ? 4 : 5;
+        case RAKU_JSON_NUMBER:
+            return raku_json_number_size((struct json_number*)value);
+        default:
+            ASSERT(false, "measure_value: invalid json value.");
+        case RAKU_JSON_NULL:
+            return 4;
+        case RAKU_JSON_STRING:
+        {
+            const struct json_string *string = (struct json_string*)value;
+            return measure_string(raku_string_chars(&string->value), string->value.count);
+        }
+        case RAKU_JSON_ARRAY:
+        {
+            struct json_array *array = (struct json_array*)value;
+            if (array->count == 0)
+                return 2;
+
+            union json_scalar scratch;
+            size_t size = 2 + (array->count - 1);
+            for (unsigned int i = 0; i < array->count; ++i)
+                size += measure_value(writer, raku_json_array_peek(array, i, &scratch), level+1);
+
+            if (writer->indent_size != 0)
+                size += (array->count * (1 + (writer->indent_size * (level+1)))) + 1 + (writer->indent_size * level);
+            return size;
+        }
+        case RAKU_JSON_OBJECT:
+        {
+            struct json_object *object = (struct json_object*)value;
+            if (object->count == 0)
+                return 2;
+
+            size_t size = 2 + (object->count - 1);
+            for (unsigned int i = 0; i < object->used; ++i)
+            {
+                const struct json_member *member = object->members+i;
+                if (member->key == NULL)
+                    continue;
+
+                size += measure_string(member->key->chars, member->key->count) + 1;
+                size += measure_value(writer, member->value, level+1);
+            }
+
+            if (writer->indent_size != 0)
+                size += (object->count * (2 + (writer->indent_size * (level+1)))) + 1 + (writer->indent_size * level);
+            return size;
+        }
+    }
+}
+
+static char* emit_string(const char *chars, unsigned int count, char *out)
+{
+    const unsigned char *c = (const unsigned char*)chars;
+    const unsigned char *end = c + count;
+
+    *out++ = '"';
+    while (c != end)
+    {
+        const unsigned char *run = c;
+        while (c != end && escape_sizes[*c] == 1)
+            ++c;
+
+        memcpy(out, run, (size_t)(c - run));
+        out += c - run;
+        if (c == end)
+            break;
+
+        *out++ = '\\';
+        switch (*c)
+        {
+            case '"':
+            case '\\':
+            case '/':
+                *out++ = (char)*c;
+                break;
+            case '\b':
+                *out++ = 'b';
+                break;
+            case '\f':
+                *out++ = 'f';
+                break;
+            case '\n':
+                *out++ = 'n';
+                break;
+            case '\r':
+                *out++ = 'r';
+                break;
+            case '\t':
+                *out++ = 't';
+                break;
+            default:
+                memcpy(out, "u00", 3);
+                out[3] = hex_digits[*c >> 4];
+                out[4] = hex_digits[*c & 0xF];
+                out += 5;
+                break;
+        }
+        ++c;
+    }
+
+    *out++ = '"';
+    return out;
+}
+
+static char* emit_newline(const struct json_writer *writer, size_t level, char *out)
+{
+    *out++ = '\n';
+    for (size_t i = 0; i < level; ++i)
+    {
+        memcpy(out, writer->indent, writer->indent_size);
+        out += writer->indent_size;
+    }
+    return out;
+}
+
+static char* emit_value(const struct json_writer *writer, struct json_value *value, size_t level, char *out)
+{
+    switch (raku_json_value_get_type(value))
+    {
+        case RAKU_JSON_BOOL:
+            if (((struct json_bool*)value)->value)
+            {
+                memcpy(out, "true", 4);
+                return out + 4;
+            }
+            memcpy(out, "false", 5);
+            return out + 5;
+        case RAKU_JSON_NUMBER:
+            return out + raku_json_number_format((struct json_number*)value, out);
+        default:
+            ASSERT(false, "emit_value: invalid json value.");
+        case RAKU_JSON_NULL:
+            memcpy(out, "null", 4);
+            return out + 4;
+        case RAKU_JSON_STRING:
+        {
+            const struct json_string *string = (struct json_string*)value;
+            return emit_string(raku_string_chars(&string->value), string->value.count, out);
+        }
+        case RAKU_JSON_ARRAY:
+        {
+            struct json_array *array = (struct json_array*)value;
+            union json_scalar scratch;
+
+            *out++ = '[';
+            for (unsigned int i = 0; i < array->count; ++i)
+            {
+                if (i != 0)
+                    *out++ = ',';
+                if (writer->indent_size != 0)
+                    out = emit_newline(writer, level+1, out);
+
+                out = emit_value(writer, raku_json_array_peek(array, i, &scratch), level+1, out);
+            }
+
+            if (array->count != 0 && writer->indent_size != 0)
+                out = emit_newline(writer, level, out);
+            *out++ = ']';
+            return out;
+        }
+        case RAKU_JSON_OBJECT:
+        {
+            struct json_object *object = (struct json_object*)value;
+
+            *out++ = '{';
+            bool first = true;
+            for (unsigned int i = 0; i < object->used; ++i)
+            {
+                const struct json_member *member = object->members+i;
+                if (member->key == NULL)
+                    continue;
+
+                if (!first)
+                    *out++ = ',';
+                first = false;
+                if (writer->indent_size != 0)
+                    out = emit_newline(writer, level+1, out);
+
+                out = emit_string(member->key->chars, member->key->count, out);
+                *out++ = ':';
+                if (writer->indent_size != 0)
+                    *out++ = ' ';
+
+                out = emit_value(writer, member->value, level+1, out);
+            }
+
+            if (object->count != 0 && writer->indent_size != 0)
+                out = emit_newline(writer, level, out);
+            *out++ = '}';
+            return out;
+        }
+    }
+}
+
+RAKU_API
+size_t raku_json_value_measure(struct json_value *value, enum json_format_option options)
+{
+    struct json_writer writer;
+    json_writer_init(&writer, options);
+    return measure_value(&writer, value, 0);
+}
+
+RAKU_API
+enum raku_status raku_json_value_to_buffer(
+    struct json_value *value,
+    enum json_format_option options,
+    char *buffer,
+    size_t size,
+    size_t *written)
+{
+    ASSERT(buffer != NULL || size == 0,
+           "raku_json_value_to_buffer: buffer must not be NULL!");
+
+    struct json_writer writer;
+    json_writer_init(&writer, options);
+
+    size_t required = measure_value(&writer, value, 0);
+    if (written)
+        *written = required;
+    if (required > size)
+        return RAKU_OUT_OF_RANGE;
+
+    char *end = emit_value(&writer, value, 0, buffer);
+    ASSERT(end == buffer + required,
+           "raku_json_value_to_buffer: measured size does not match the output.");
+    (void)end;
+
+    return RAKU_OK;
+}
+
+RAKU_API
+enum raku_status raku_json_value_to_string(struct json_value *value, enum json_format_option options, struct raku_string *out)
+{
+    struct json_writer writer;
+    json_writer_init(&writer, options);
+
+    size_t size = measure_value(&writer, value, 0);
+    if (size >= UINT_MAX)
+        return RAKU_NO_MEMORY;
+
+    out->count = 0;
+
+    char *chars;
+    enum raku_status status = raku_string_span(out, (unsigned int)size, &chars);
+    if (status != RAKU_OK)
+        return status;
+
+    char *end = emit_value(&writer, value, 0, chars);
+    ASSERT(end == chars + size,
+           "raku_json_value_to_string: measured size does not match the output.");
+
+    raku_string_commit(out, (unsigned int)size);
+    return RAKU_OK;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <RAKU/snowflake.h>
+#include <RAKU/debug.h>
+
+#include <string.h>
+
+#define SNOWFLAKE_MAX_DIGITS 20
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    #define SWAR_BIG_ENDIAN
+#endif
+
+static inline uint64_t read_eight(const char *chars)
+{
+    uint64_t value;
+    memcpy(&value, chars, sizeof(value));
+#if defined(SWAR_BIG_ENDIAN)
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+static inline bool is_eight_digits(uint64_t value)
+{
+    return
+        ((value & 0xF0F0F0F0F0F0F0F0ULL) |
+        (((value + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+/* Converts eight ASCII digits, first digit in the lowest byte, in three multiplications. */
+static inline uint32_t parse_eight(uint64_t value)
+{
+    value = ((value & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    value = ((value & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return (uint32_t)(((value & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+RAKU_API
+enum raku_status raku_snowflake_parse(const char *chars, unsigned int count, raku_snowflake *out)
+{
+    ASSERT(chars != NULL || count == 0,
+           "raku_snowflake_parse: chars must not be NULL!");
+
+    if (count == 0 || count > SNOWFLAKE_MAX_DIGITS)
+        return RAKU_JSON_INVALID_SNOWFLAKE;
+
+    const char *end = chars + count;
+    uint64_t value = 0;
+    while (end - chars >= 8)
+    {
+        uint64_t block = read_eight(chars);
+        if (!is_eight_digits(block))
+            return RAKU_JSON_INVALID_SNOWFLAKE;
+
+        value = (value * 100000000) + parse_eight(block);
+        chars += 8;
+    }
+
+    /* Only a 20 digit input can overflow, and only in its last four digits. */
+    for (; chars != end; ++chars)
+    {
+        uint64_t digit = (uint64_t)(unsigned char)(*chars - '0');
+        if (digit > 9 || value > (UINT64_MAX - digit) / 10)
+            return RAKU_JSON_INVALID_SNOWFLAKE;
+
+        value = (value * 10) + digit;
+    }
+
+    *out = value;
+    return RAKU_OK;
+}
+
+RAKU_API
+uint64_t raku_snowflake_timestamp(raku_snowflake snowflake)
+{
+    return (snowflake >> 22) + RAKU_SNOWFLAKE_EPOCH;
+}
+
+RAKU_API
+uint8_t raku_snowflake_worker(raku_snowflake snowflake)
+{
+    return (uint8_t)((snowflake >> 17) & 0x1F);
+}
+
+RAKU_API
+uint8_t raku_snowflake_process(raku_snowflake snowflake)
+{
+    return (uint8_t)((snowflake >> 12) & 0x1F);
+}
+
+RAKU_API
+uint16_t raku_snowflake_sequence(raku_snowflake snowflake)
+{
+    return (uint16_t)(snowflake & 0xFFF);
+}
\ No newline at end of file
@@ -3,9 +3,17 @@
 #include <RAKU/debug.h>
 
 #include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
 
 #define STRING_BASE_CAPACITY 8
+#define STRING_INLINE_CAPACITY (RAKU_STRING_INLINE_SIZE - 1)
+
+static inline unsigned int capacity_of(const struct raku_string *string)
+{
+    return string->is_inline ? STRING_INLINE_CAPACITY : string->data.heap.capacity;
+}
 
 RAKU_API
 void raku_string_init(struct raku_string *string)
@@ -13,9 +21,10 @@ void raku_string_init(struct raku_string *string)
     ASSERT(string != NULL,
            "raku_string_init: string must not be NULL!");
 
-    string->chars = NULL;
+    string->data.heap.chars = NULL;
+    string->data.heap.capacity = 0;
     string->count = 0;
-    string->capacity = 0;
+    string->is_inline = false;
 }
 
 RAKU_API
@@ -24,7 +33,8 @@ void raku_string_free(struct raku_string *string)
     ASSERT(string != NULL,
            "raku_string_free: string must not be NULL!");
 
-    raku_free(string->chars);
+    if (!string->is_inline)
+        raku_free_for(RAKU_MEMORY_STRINGS, string->data.heap.chars, (size_t)string->data.heap.capacity + 1);
     raku_string_init(string);
 }
 
@@ -52,9 +62,9 @@ void raku_string_ownc(struct raku_string *string, char *other)
     unsigned int count = strnlen(other, UINT_MAX);
 
     raku_string_free(string);
-    string->chars = other;
+    string->data.heap.chars = other;
+    string->data.heap.capacity = count;
     string->count = count;
-    string->capacity = count;
 }
 
 RAKU_API
@@ -92,28 +102,51 @@ static enum raku_status grow_string(struct raku_string *string, unsigned int siz
         return RAKU_NO_MEMORY;
 
     unsigned int new_capacity;
+    unsigned int capacity = capacity_of(string);
     unsigned int min_capacity = string->count + size;
-    if (min_capacity > (UINT_MAX / 2))
+    if (raku_string_chars(string) == NULL && min_capacity <= STRING_INLINE_CAPACITY)
+    {
+        string->is_inline = true;
+        return RAKU_OK;
+    }
+    else if (min_capacity > (UINT_MAX / 2))
         new_capacity = min_capacity+7;
     else
     {
         new_capacity =
-            (string->capacity < STRING_BASE_CAPACITY) ?
+            (capacity < STRING_BASE_CAPACITY) ?
                 STRING_BASE_CAPACITY :
-                2 * string->capacity;
+                2 * capacity;
         
         if (new_capacity < min_capacity)
             new_capacity = min_capacity;
     }
     
-    enum raku_status status = raku_realloc(
-        string->chars,
-        (new_capacity+1) * sizeof(char),
-        (void**)&string->chars
-    );
+    enum raku_status status;
+    if (string->is_inline)
+    {
+        char *chars;
+        status = raku_alloc_for(RAKU_MEMORY_STRINGS, (new_capacity+1) * sizeof(char), (void**)&chars);
+        if (status == RAKU_OK)
+        {
+            memcpy(chars, string->data.chars, string->count);
+            string->data.heap.chars = chars;
+            string->is_inline = false;
+        }
+    }
+    else
+    {
+        status = raku_realloc_for(
+            RAKU_MEMORY_STRINGS,
+            string->data.heap.chars,
+            (capacity+1) * sizeof(char),
+            (new_capacity+1) * sizeof(char),
+            (void**)&string->data.heap.chars
+        );
+    }
 
     if (status == RAKU_OK)
-        string->capacity = new_capacity;
+        string->data.heap.capacity = new_capacity;
     
     return status;
 }
@@ -125,15 +158,16 @@ enum raku_status raku_string_write(struct raku_string *string, char c)
            "raku_string_write: string must not be NULL!");
 
     enum raku_status status = RAKU_OK;
-    if (string->count+1 > string->capacity)
+    if (string->count+1 > capacity_of(string))
     {
         status = grow_string(string, 1);
         if (status != RAKU_OK)
             goto rsw_error;
     }
 
-    string->chars[string->count++] = c;
-    string->chars[string->count] = '\0';
+    char *chars = raku_string_chars(string);
+    chars[string->count++] = c;
+    chars[string->count] = '\0';
 
 rsw_error:
     return status;
@@ -147,20 +181,7 @@ enum raku_status raku_string_writes(struct raku_string *string, const struct rak
     ASSERT(other != NULL,
            "raku_string_writes: other must not be NULL!");
 
-    enum raku_status status = RAKU_OK;
-    if (string->count+other->count > string->capacity)
-    {
-        status = grow_string(string, other->count);
-        if (status != RAKU_OK)
-            goto rsws_error;
-    }
-
-    strncpy(string->chars+string->count, other->chars, other->count);
-    string->count += other->count;
-    string->chars[string->count] = '\0';
-
-rsws_error:
-    return status;
+    return raku_string_append_n(string, raku_string_chars(other), other->count);
 }
 
 RAKU_API
@@ -171,21 +192,120 @@ enum raku_status raku_string_writesc(struct raku_string *string, const char *oth
     ASSERT(other != NULL,
            "raku_string_writesc: other must not be NULL!");
 
-    unsigned int count = strnlen(other, UINT_MAX);
-    enum raku_status status = RAKU_OK;
-    if (string->count+count > string->capacity)
+    return raku_string_append_n(string, other, strnlen(other, UINT_MAX));
+}
+
+RAKU_API
+enum raku_status raku_string_reserve(struct raku_string *string, unsigned int capacity)
+{
+    ASSERT(string != NULL,
+           "raku_string_reserve: string must not be NULL!");
+
+    if (capacity <= capacity_of(string))
+        return RAKU_OK;
+
+    return grow_string(string, capacity - string->count);
+}
+
+RAKU_API
+enum raku_status raku_string_append_n(struct raku_string *string, const char *chars, unsigned int count)
+{
+    ASSERT(string != NULL,
+           "raku_string_append_n: string must not be NULL!");
+    ASSERT(chars != NULL || count == 0,
+           "raku_string_append_n: chars must not be NULL!");
+
+    if (count == 0)
+        return RAKU_OK;
+
+    if (count > capacity_of(string) - string->count)
     {
-        status = grow_string(string, count);
+        enum raku_status status = grow_string(string, count);
         if (status != RAKU_OK)
-            goto rswsc_error;
+            return status;
     }
 
-    strncpy(string->chars+string->count, other, count);
+    char *end = raku_string_chars(string) + string->count;
+    memcpy(end, chars, count);
+    end[count] = '\0';
     string->count += count;
-    string->chars[string->count] = '\0';
 
-rswsc_error:
-    return status;
+    return RAKU_OK;
+}
+
+RAKU_API
+enum raku_status raku_string_append_fmt(struct raku_string *string, const char *format, ...)
+{
+    ASSERT(string != NULL,
+           "raku_string_append_fmt: string must not be NULL!");
+    ASSERT(format != NULL,
+           "raku_string_append_fmt: format must not be NULL!");
+
+    /* Format straight into the spare capacity, and again only if it was too small. */
+    unsigned int spare = capacity_of(string) - string->count;
+    char *chars = raku_string_chars(string);
+    char *end = (chars != NULL) ? chars+string->count : NULL;
+
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(end, (end != NULL) ? (size_t)spare+1 : 0, format, args);
+    va_end(args);
+
+    if (size < 0)
+        return RAKU_OUT_OF_RANGE;
+    else if ((unsigned int)size > spare)
+    {
+        enum raku_status status = grow_string(string, (unsigned int)size);
+        if (status != RAKU_OK)
+        {
+            if (end != NULL)
+                *end = '\0';
+            return status;
+        }
+
+        va_start(args, format);
+        vsnprintf(raku_string_chars(string)+string->count, (size_t)size+1, format, args);
+        va_end(args);
+    }
+
+    string->count += (unsigned int)size;
+    return RAKU_OK;
+}
+
+RAKU_API
+enum raku_status raku_string_span(struct raku_string *string, unsigned int size, char **out)
+{
+    ASSERT(string != NULL,
+           "raku_string_span: string must not be NULL!");
+    ASSERT(out != NULL,
+           "raku_string_span: out must not be NULL!");
+
+    if (size > capacity_of(string) - string->count)
+    {
+        enum raku_status status = grow_string(string, size);
+        if (status != RAKU_OK)
+            return status;
+    }
+
+    char *chars = raku_string_chars(string);
+    *out = (chars != NULL) ? chars+string->count : NULL;
+    return RAKU_OK;
+}
+
+RAKU_API
+void raku_string_commit(struct raku_string *string, unsigned int count)
+{
+    ASSERT(string != NULL,
+           "raku_string_commit: string must not be NULL!");
+    ASSERT(count <= capacity_of(string) - string->count,
+           "raku_string_commit: count exceeds the span.");
+
+    char *chars = raku_string_chars(string);
+    if (chars == NULL)
+        return;
+
+    string->count += count;
+    chars[string->count] = '\0';
 }
 
 RAKU_API
@@ -198,7 +318,7 @@ bool raku_string_equal(const struct raku_string *string, const struct raku_strin
 
     return
         (string->count == other->count) &&
-        (strncmp(string->chars, other->chars, string->count) == 0);
+        (strncmp(raku_string_chars(string), raku_string_chars(other), string->count) == 0);
 }
 
 RAKU_API
@@ -212,5 +332,5 @@ bool raku_string_equalc(const struct raku_string *string, const char *other)
     unsigned int count = strnlen(other, UINT_MAX);
     return
         (string->count == count) &&
-        (strncmp(string->chars, other, count) == 0);
+        (strncmp(raku_string_chars(string), other, count) == 0);
 }
\ No newline at end of file